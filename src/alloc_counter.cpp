@@ -0,0 +1,59 @@
+#include "alloc_counter.h"
+
+#ifdef SNAKE_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::uint64_t> allocations{0};
+
+void *CountedAlloc(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void *pointer = std::malloc(size ? size : 1);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+}  // namespace
+
+void *operator new(std::size_t size) { return CountedAlloc(size); }
+void *operator new[](std::size_t size) { return CountedAlloc(size); }
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+#endif  // SNAKE_COUNT_ALLOCATIONS
+
+namespace AllocCounter {
+
+/**
+ * @brief Tells whether allocation counting was compiled in.
+ *
+ * @return True if the build defines SNAKE_COUNT_ALLOCATIONS.
+ */
+bool Enabled(void)
+{
+#ifdef SNAKE_COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Returns the number of heap allocations since the program started.
+ *
+ * @return The allocation count, or 0 if counting is not compiled in.
+ */
+std::uint64_t Count(void)
+{
+#ifdef SNAKE_COUNT_ALLOCATIONS
+    return allocations.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+}
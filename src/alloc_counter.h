@@ -0,0 +1,18 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstdint>
+
+/**
+ * @brief Opt-in heap allocation accounting.
+ *
+ * When the build defines SNAKE_COUNT_ALLOCATIONS (cmake -DSNAKE_COUNT_ALLOCATIONS=ON),
+ * the global operator new is replaced by one that counts every allocation made by
+ * any thread. Otherwise Enabled() is false and Count() always returns 0.
+ */
+namespace AllocCounter {
+bool Enabled(void);
+std::uint64_t Count(void);
+}
+
+#endif /* ALLOC_COUNTER_H */
@@ -0,0 +1,382 @@
+#include "arena.h"
+#include <chrono>
+#include <iostream>
+#include "frame_pacer.h"
+#include "snake.h"
+
+namespace {
+// The arena ticks once every kTickFrames frames, i.e. 10 cells per second at 60 FPS.
+constexpr int kTickFrames{6};
+
+// Directions use the numeric value of Snake::Direction; d ^ 1 is the opposite of d.
+constexpr std::uint8_t kUp{static_cast<std::uint8_t>(Snake::Direction::kUp)};
+constexpr std::uint8_t kDown{static_cast<std::uint8_t>(Snake::Direction::kDown)};
+constexpr std::uint8_t kLeft{static_cast<std::uint8_t>(Snake::Direction::kLeft)};
+constexpr std::uint8_t kRight{static_cast<std::uint8_t>(Snake::Direction::kRight)};
+static_assert((kUp ^ 1) == kDown && (kLeft ^ 1) == kRight, "Direction values must pair up");
+
+int WrappedDistance(int a, int b, int size) {
+  int d = (a > b) ? a - b : b - a;
+  return (d < size - d) ? d : size - d;
+}
+}  // namespace
+
+/**
+ * @brief Constructs an arena and spawns every snake and food item.
+ *
+ * @param grid_width The width of the board.
+ * @param grid_height The height of the board.
+ * @param snake_count The number of AI snakes.
+ * @param thread_count The number of threads used by the propose phase.
+ */
+Arena::Arena(std::size_t grid_width, std::size_t grid_height, std::size_t snake_count,
+             std::size_t thread_count)
+    : grid_width(grid_width),
+      grid_height(grid_height),
+      snake_count(snake_count),
+      heads(snake_count),
+      targets(snake_count),
+      proposals(snake_count),
+      directions(snake_count, kUp),
+      alive(snake_count, 0),
+      lengths(snake_count, 0),
+      tails(snake_count, 0),
+      growth(snake_count, 0),
+      seeds(snake_count),
+      bodies(snake_count * kMaxLength),
+      occupancy(grid_width * grid_height, kFree),
+      foods(snake_count / 2 + 1),
+      seed(0x9E3779B9u),
+      workers(thread_count) {
+  for (std::size_t i = 0; i < snake_count; ++i) {
+    seeds[i] = static_cast<std::uint32_t>(i * 0x85EBCA6Bu) ^ 0xC2B2AE35u;
+    Spawn(i);
+  }
+  for (std::size_t i = 0; i < foods.size(); ++i) {
+    if (!PlaceFood(i)) {
+      unplaced_foods.push_back(static_cast<std::uint32_t>(i));
+    }
+  }
+}
+
+/**
+ * @brief Runs the arena loop until the window is closed.
+ *
+ * @param controller The controller object responsible for handling user input.
+ * @param renderer The renderer object responsible for rendering the arena.
+ * @param target_frame_duration The target duration for each frame in milliseconds; may be fractional.
+ */
+void Arena::Run(Controller &controller, Renderer &renderer,
+                double target_frame_duration) {
+  Uint32 title_timestamp = SDL_GetTicks();
+  Uint32 frame_end;
+  int frame_count = 0;
+  bool running = true;
+  std::size_t ticks = 0;
+  std::chrono::nanoseconds tick_time{0};
+  FramePacer pacer(target_frame_duration, renderer.HasVsync());
+
+  while (running) {
+    controller.HandleInput(running);
+    if (frame_count % kTickFrames == 0) {
+      auto tick_start = std::chrono::steady_clock::now();
+      Tick();
+      tick_time += std::chrono::steady_clock::now() - tick_start;
+      ticks++;
+    }
+    renderer.RenderArena(*this);
+
+    frame_end = SDL_GetTicks();
+    frame_count++;
+
+    if (frame_end - title_timestamp >= 1000) {
+      renderer.UpdateWindowTitle(static_cast<int>(LongestSnake()), frame_count);
+      frame_count = 0;
+      title_timestamp = frame_end;
+    }
+
+    pacer.Wait();
+  }
+
+  if (ticks > 0) {
+    std::cout << "Arena: " << ticks << " ticks, "
+              << std::chrono::duration_cast<std::chrono::microseconds>(tick_time).count() / ticks
+              << " us per tick with " << workers.Size() << " threads, "
+              << AliveCount() << "/" << snake_count << " snakes alive" << std::endl;
+  }
+}
+
+/**
+ * @brief Advances every snake by one cell.
+ *
+ * Phase 1 computes every snake's next cell in parallel from the previous tick's state.
+ * Phase 2 applies the moves sequentially in snake id order.
+ */
+void Arena::Tick(void) {
+  auto propose = [this](std::size_t begin, std::size_t end) { ProposeMoves(begin, end); };
+  workers.ParallelFor(snake_count, propose);
+  ResolveMoves();
+}
+
+/**
+ * @brief Picks the next cell of a range of snakes.
+ *
+ * Each snake steers toward its target food and avoids occupied cells, breaking ties with its
+ * own random state. Only per-snake fields of the range are written.
+ *
+ * @param begin The first snake id of the range.
+ * @param end One past the last snake id of the range.
+ */
+void Arena::ProposeMoves(std::size_t begin, std::size_t end) {
+  int const grid_w = static_cast<int>(grid_width);
+  int const grid_h = static_cast<int>(grid_height);
+
+  for (std::size_t i = begin; i < end; ++i) {
+    if (!alive[i]) continue;
+
+    std::uint32_t &state = seeds[i];
+    if ((OccupantAt(targets[i]) & kFoodFlag) == 0) {
+      targets[i] = foods[NextRandom(state) % foods.size()];
+    }
+
+    std::uint8_t const current = directions[i];
+    std::uint8_t const options[3] = {current, static_cast<std::uint8_t>(current < kLeft ? kLeft : kUp),
+                                     static_cast<std::uint8_t>(current < kLeft ? kRight : kDown)};
+    std::uint8_t best = current;
+    int best_score = -1;
+    for (std::uint8_t direction : options) {
+      Cell next = Neighbour(heads[i], direction);
+      std::uint32_t occupant = OccupantAt(next);
+      if (occupant != kFree && (occupant & kFoodFlag) == 0) continue;
+
+      int distance = WrappedDistance(next.x, targets[i].x, grid_w) +
+                     WrappedDistance(next.y, targets[i].y, grid_h);
+      // Lower distance wins; the random low bits break ties.
+      int score = (grid_w + grid_h - distance) * 4 + static_cast<int>(NextRandom(state) & 3u);
+      if (score > best_score) {
+        best_score = score;
+        best = direction;
+      }
+    }
+
+    directions[i] = best;
+    proposals[i] = Neighbour(heads[i], best);
+  }
+}
+
+/**
+ * @brief Applies the proposed moves in snake id order.
+ *
+ * Tails move first, so a snake may enter a cell vacated in the same tick. A snake dies when it
+ * enters a cell held by a body or by a head that already moved this tick, so the lower id wins
+ * head-on conflicts. Dead snakes respawn at a random free cell.
+ */
+void Arena::ResolveMoves(void) {
+  for (std::size_t i = 0; i < snake_count; ++i) {
+    if (!alive[i]) continue;
+    if (growth[i] > 0 && lengths[i] < kMaxLength) {
+      growth[i]--;
+      continue;
+    }
+    Cell &tail = bodies[i * kMaxLength + tails[i]];
+    occupancy[Index(tail)] = kFree;
+    tails[i] = (tails[i] + 1) % kMaxLength;
+    lengths[i]--;
+  }
+
+  for (std::size_t i = 0; i < snake_count; ++i) {
+    if (!alive[i]) continue;
+
+    Cell next = proposals[i];
+    std::uint32_t occupant = occupancy[Index(next)];
+    if (occupant != kFree && (occupant & kFoodFlag) == 0) {
+      Kill(i);
+      continue;
+    }
+
+    bodies[i * kMaxLength + (tails[i] + lengths[i]) % kMaxLength] = next;
+    lengths[i]++;
+    heads[i] = next;
+    occupancy[Index(next)] = static_cast<std::uint32_t>(i + 1);
+
+    if (occupant & kFoodFlag) {
+      growth[i]++;
+      std::uint32_t food_index = occupant & ~kFoodFlag;
+      if (!PlaceFood(food_index)) {
+        unplaced_foods.push_back(food_index);
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < snake_count; ++i) {
+    if (!alive[i]) Spawn(i);
+  }
+  for (std::size_t i = unplaced_foods.size(); i > 0; --i) {
+    if (PlaceFood(unplaced_foods[i - 1])) {
+      unplaced_foods.erase(unplaced_foods.begin() + (i - 1));
+    }
+  }
+}
+
+/**
+ * @brief Places a new snake of length one at a random free cell; it grows to kSpawnLength.
+ *
+ * @param id The snake id.
+ */
+void Arena::Spawn(std::size_t id) {
+  Cell cell;
+  if (!RandomFreeCell(cell)) return;
+
+  alive[id] = 1;
+  heads[id] = cell;
+  targets[id] = cell;
+  proposals[id] = cell;
+  directions[id] = static_cast<std::uint8_t>(NextRandom(seed) & 3u);
+  tails[id] = 0;
+  lengths[id] = 1;
+  growth[id] = kSpawnLength - 1;
+  bodies[id * kMaxLength] = cell;
+  occupancy[Index(cell)] = static_cast<std::uint32_t>(id + 1);
+}
+
+/**
+ * @brief Removes a snake and frees every cell of its body.
+ *
+ * @param id The snake id.
+ */
+void Arena::Kill(std::size_t id) {
+  for (std::uint32_t k = 0; k < lengths[id]; ++k) {
+    Cell cell = bodies[id * kMaxLength + (tails[id] + k) % kMaxLength];
+    if (occupancy[Index(cell)] == id + 1) {
+      occupancy[Index(cell)] = kFree;
+    }
+  }
+  alive[id] = 0;
+  lengths[id] = 0;
+  growth[id] = 0;
+}
+
+/**
+ * @brief Moves a food item to a random free cell.
+ *
+ * @param food_index The index of the food item.
+ *
+ * @return True if a free cell was found.
+ */
+bool Arena::PlaceFood(std::size_t food_index) {
+  Cell cell;
+  if (!RandomFreeCell(cell)) return false;
+  foods[food_index] = cell;
+  occupancy[Index(cell)] = kFoodFlag | static_cast<std::uint32_t>(food_index);
+  return true;
+}
+
+/**
+ * @brief Draws a random free cell with a bounded number of attempts.
+ *
+ * @param cell Receives the free cell.
+ *
+ * @return True if a free cell was found.
+ */
+bool Arena::RandomFreeCell(Cell &cell) {
+  for (int attempt = 0; attempt < 64; ++attempt) {
+    Cell candidate(static_cast<int>(NextRandom(seed) % grid_width),
+                   static_cast<int>(NextRandom(seed) % grid_height));
+    if (OccupantAt(candidate) == kFree) {
+      cell = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Returns the neighbour of a cell, wrapping around the board.
+ *
+ * @param cell The cell to move from.
+ * @param direction The direction to move in.
+ *
+ * @return The neighbouring cell.
+ */
+Cell Arena::Neighbour(Cell cell, std::uint8_t direction) const {
+  int x = cell.x;
+  int y = cell.y;
+  int const grid_w = static_cast<int>(grid_width);
+  int const grid_h = static_cast<int>(grid_height);
+  switch (direction) {
+    case kUp:
+      y = (y == 0) ? grid_h - 1 : y - 1;
+      break;
+    case kDown:
+      y = (y + 1 == grid_h) ? 0 : y + 1;
+      break;
+    case kLeft:
+      x = (x == 0) ? grid_w - 1 : x - 1;
+      break;
+    default:
+      x = (x + 1 == grid_w) ? 0 : x + 1;
+      break;
+  }
+  return Cell(x, y);
+}
+
+/**
+ * @brief Advances a xorshift32 random state.
+ *
+ * @param state The state to advance; must not be zero.
+ *
+ * @return The next random value.
+ */
+std::uint32_t Arena::NextRandom(std::uint32_t &state) const {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+/**
+ * @brief Checks whether a cell holds the head of a live snake.
+ *
+ * @param cell The cell to check.
+ *
+ * @return True if the cell is a head.
+ */
+bool Arena::IsHead(Cell cell) const {
+  std::uint32_t occupant = OccupantAt(cell);
+  if (occupant == kFree || (occupant & kFoodFlag)) return false;
+  return heads[occupant - 1] == cell;
+}
+
+/**
+ * @brief Returns the cell the camera follows: the head of the first live snake.
+ *
+ * @return The focus cell, or the centre of the board if every snake is dead.
+ */
+Cell Arena::FocusCell(void) const {
+  for (std::size_t i = 0; i < snake_count; ++i) {
+    if (alive[i]) return heads[i];
+  }
+  return Cell(static_cast<int>(grid_width / 2), static_cast<int>(grid_height / 2));
+}
+
+/**
+ * @brief Returns the number of live snakes.
+ */
+std::size_t Arena::AliveCount(void) const {
+  std::size_t count = 0;
+  for (std::uint8_t flag : alive) {
+    count += flag;
+  }
+  return count;
+}
+
+/**
+ * @brief Returns the length of the longest live snake.
+ */
+std::size_t Arena::LongestSnake(void) const {
+  std::size_t longest = 0;
+  for (std::size_t i = 0; i < snake_count; ++i) {
+    if (alive[i] && lengths[i] > longest) longest = lengths[i];
+  }
+  return longest;
+}
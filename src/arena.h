@@ -0,0 +1,87 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cell.h"
+#include "controller.h"
+#include "renderer.h"
+#include "worker_pool.h"
+
+/**
+ * @brief Board shared by many AI snakes.
+ *
+ * Snake state is stored data-oriented: one contiguous array per field, indexed
+ * by snake id, and one ring-buffer segment per snake inside a shared body
+ * array. A dense occupancy grid records which snake (or food) holds each cell.
+ *
+ * Each tick runs in two phases: every snake proposes its next cell in parallel,
+ * reading only the state of the previous tick, then a sequential pass in snake
+ * id order resolves collisions and moves. The result does not depend on the
+ * number of threads.
+ */
+class Arena {
+ public:
+  // Occupancy values: kFree, a snake id plus one, or kFoodFlag | food index.
+  static constexpr std::uint32_t kFree{0};
+  static constexpr std::uint32_t kFoodFlag{0x80000000u};
+
+  Arena(std::size_t grid_width, std::size_t grid_height, std::size_t snake_count,
+        std::size_t thread_count);
+
+  void Run(Controller &controller, Renderer &renderer,
+           double target_frame_duration);
+  void Tick(void);
+
+  std::uint32_t OccupantAt(Cell cell) const { return occupancy[Index(cell)]; }
+  bool IsHead(Cell cell) const;
+  Cell FocusCell(void) const;
+  std::size_t AliveCount(void) const;
+  std::size_t LongestSnake(void) const;
+  std::size_t GetGridWidth(void) const { return grid_width; }
+  std::size_t GetGridHeight(void) const { return grid_height; }
+
+ private:
+  static constexpr std::uint32_t kMaxLength{256};
+  static constexpr std::uint32_t kSpawnLength{3};
+
+  std::size_t grid_width;
+  std::size_t grid_height;
+  std::size_t snake_count;
+
+  // Per-snake fields.
+  std::vector<Cell> heads;
+  std::vector<Cell> targets;
+  std::vector<Cell> proposals;
+  std::vector<std::uint8_t> directions;
+  std::vector<std::uint8_t> alive;
+  std::vector<std::uint32_t> lengths;
+  std::vector<std::uint32_t> tails;
+  std::vector<std::uint32_t> growth;
+  std::vector<std::uint32_t> seeds;
+
+  // Snake i owns bodies[i * kMaxLength, (i + 1) * kMaxLength) as a ring buffer.
+  std::vector<Cell> bodies;
+  std::vector<std::uint32_t> occupancy;
+  std::vector<Cell> foods;
+  std::vector<std::uint32_t> unplaced_foods;
+  std::uint32_t seed;
+
+  WorkerPool workers;
+
+  std::size_t Index(Cell cell) const {
+    return static_cast<std::size_t>(cell.y) * grid_width + cell.x;
+  }
+  Cell Neighbour(Cell cell, std::uint8_t direction) const;
+  std::uint32_t NextRandom(std::uint32_t &state) const;
+  bool RandomFreeCell(Cell &cell);
+
+  void ProposeMoves(std::size_t begin, std::size_t end);
+  void ResolveMoves(void);
+  void Spawn(std::size_t id);
+  void Kill(std::size_t id);
+  bool PlaceFood(std::size_t food_index);
+};
+
+#endif /* ARENA_H */
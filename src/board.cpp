@@ -0,0 +1,63 @@
+#include "board.h"
+
+namespace {
+bool IsPowerOfTwo(int value) { return value > 0 && (value & (value - 1)) == 0; }
+
+void BuildTables(int size, std::vector<std::uint16_t> &next, std::vector<std::uint16_t> &prev) {
+  next.resize(size);
+  prev.resize(size);
+  for (int i = 0; i < size; ++i) {
+    next[i] = static_cast<std::uint16_t>((i + 1) % size);
+    prev[i] = static_cast<std::uint16_t>((i - 1 + size) % size);
+  }
+}
+
+int WrapTable(int value, int delta, int size, const std::vector<std::uint16_t> &next,
+              const std::vector<std::uint16_t> &prev) {
+  if (delta == 0) return value;
+  if (delta == 1) return next[value];
+  if (delta == -1) return prev[value];
+  return ((value + delta) % size + size) % size;
+}
+}  // namespace
+
+/**
+ * @brief Constructs a board and selects its move function.
+ *
+ * @param width The width of the board in cells.
+ * @param height The height of the board in cells.
+ */
+Board::Board(int width, int height) : width_(width), height_(height) {
+  if (width == 16 && height == 16) {
+    move_ = &Board::MoveFixed<16, 16>;
+  } else if (width == 32 && height == 32) {
+    move_ = &Board::MoveFixed<32, 32>;
+  } else if (width == 64 && height == 64) {
+    move_ = &Board::MoveFixed<64, 64>;
+  } else if (width == 128 && height == 128) {
+    move_ = &Board::MoveFixed<128, 128>;
+  } else if (IsPowerOfTwo(width) && IsPowerOfTwo(height)) {
+    mask_x_ = width - 1;
+    mask_y_ = height - 1;
+    move_ = &Board::MoveMasked;
+  } else {
+    BuildTables(width, next_x_, prev_x_);
+    BuildTables(height, next_y_, prev_y_);
+    move_ = &Board::MoveTable;
+  }
+}
+
+/**
+ * @brief Moves a cell on a power-of-two board using runtime masks.
+ */
+Cell Board::MoveMasked(const Board &board, Cell cell, int dx, int dy) {
+  return Cell((cell.x + dx) & board.mask_x_, (cell.y + dy) & board.mask_y_);
+}
+
+/**
+ * @brief Moves a cell on a board of any size using the neighbour tables.
+ */
+Cell Board::MoveTable(const Board &board, Cell cell, int dx, int dy) {
+  return Cell(WrapTable(cell.x, dx, board.width_, board.next_x_, board.prev_x_),
+              WrapTable(cell.y, dy, board.height_, board.next_y_, board.prev_y_));
+}
@@ -0,0 +1,93 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cell.h"
+
+/**
+ * @brief Wrap-around geometry of a board whose size is known at compile time.
+ *
+ * Power-of-two sides wrap with a bit mask. Other sides use constexpr
+ * neighbour tables for single steps and a modulo for longer moves.
+ */
+template <int W, int H>
+struct FixedGeometry {
+  static_assert(W > 0 && H > 0 && W <= Cell::kMaxGridSide && H <= Cell::kMaxGridSide, "Invalid board size");
+
+  static constexpr bool kPowerOfTwoX{(W & (W - 1)) == 0};
+  static constexpr bool kPowerOfTwoY{(H & (H - 1)) == 0};
+
+  template <int N, int Delta>
+  static constexpr std::array<std::uint16_t, N> MakeTable() {
+    std::array<std::uint16_t, N> table{};
+    for (int i = 0; i < N; ++i) {
+      table[i] = static_cast<std::uint16_t>((i + Delta + N) % N);
+    }
+    return table;
+  }
+
+  static constexpr std::array<std::uint16_t, W> kNextX{MakeTable<W, 1>()};
+  static constexpr std::array<std::uint16_t, W> kPrevX{MakeTable<W, -1>()};
+  static constexpr std::array<std::uint16_t, H> kNextY{MakeTable<H, 1>()};
+  static constexpr std::array<std::uint16_t, H> kPrevY{MakeTable<H, -1>()};
+
+  template <int N, bool kPowerOfTwo>
+  static int Wrap(int value, int delta, const std::array<std::uint16_t, N> &next,
+                  const std::array<std::uint16_t, N> &prev) {
+    if constexpr (kPowerOfTwo) {
+      return (value + delta) & (N - 1);
+    } else {
+      if (delta == 1) return next[value];
+      if (delta == -1) return prev[value];
+      return ((value + delta) % N + N) % N;
+    }
+  }
+
+  static Cell Move(Cell cell, int dx, int dy) {
+    return Cell(Wrap<W, kPowerOfTwoX>(cell.x, dx, kNextX, kPrevX),
+                Wrap<H, kPowerOfTwoY>(cell.y, dy, kNextY, kPrevY));
+  }
+};
+
+/**
+ * @brief Board dimensions plus the fastest wrap-around move available for them.
+ *
+ * Common square sizes dispatch to a FixedGeometry instantiation chosen at
+ * construction. Other power-of-two sizes wrap with runtime masks, and the
+ * remaining sizes use neighbour tables built once in the constructor.
+ */
+class Board {
+ public:
+  Board(int width, int height);
+
+  int Width(void) const { return width_; }
+  int Height(void) const { return height_; }
+
+  // Moves a cell by (dx, dy) cells, wrapping around the edges; |dx| and |dy| may exceed 1.
+  Cell Move(Cell cell, int dx, int dy) const { return move_(*this, cell, dx, dy); }
+
+ private:
+  using MoveFn = Cell (*)(const Board &board, Cell cell, int dx, int dy);
+
+  template <int W, int H>
+  static Cell MoveFixed(const Board &, Cell cell, int dx, int dy) {
+    return FixedGeometry<W, H>::Move(cell, dx, dy);
+  }
+  static Cell MoveMasked(const Board &board, Cell cell, int dx, int dy);
+  static Cell MoveTable(const Board &board, Cell cell, int dx, int dy);
+
+  int width_;
+  int height_;
+  int mask_x_{0};
+  int mask_y_{0};
+  std::vector<std::uint16_t> next_x_;
+  std::vector<std::uint16_t> prev_x_;
+  std::vector<std::uint16_t> next_y_;
+  std::vector<std::uint16_t> prev_y_;
+  MoveFn move_;
+};
+
+#endif /* BOARD_H */
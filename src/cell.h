@@ -0,0 +1,53 @@
+#ifndef CELL_H
+#define CELL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "SDL.h"
+
+/**
+ * @brief Compact grid coordinate.
+ *
+ * A cell packs two 16-bit coordinates into 32 bits, half the size of an
+ * SDL_Point. Grids are therefore limited to kMaxGridSide cells on a side.
+ * Conversion to SDL_Point only happens at the SDL boundary (see ToSDLPoint).
+ */
+struct Cell {
+  static constexpr int kMaxGridSide{65536};
+
+  std::uint16_t x{0};
+  std::uint16_t y{0};
+
+  Cell() = default;
+  Cell(int x, int y)
+      : x(static_cast<std::uint16_t>(x)), y(static_cast<std::uint16_t>(y)) {}
+
+  // Packed 32-bit id, usable as a hash key or for ordering.
+  std::uint32_t Id() const {
+    return (static_cast<std::uint32_t>(y) << 16) | static_cast<std::uint32_t>(x);
+  }
+
+  static Cell FromId(std::uint32_t id) {
+    return Cell(static_cast<int>(id & 0xFFFFu), static_cast<int>(id >> 16));
+  }
+
+  SDL_Point ToSDLPoint() const {
+    return SDL_Point{static_cast<int>(x), static_cast<int>(y)};
+  }
+};
+
+inline bool operator==(Cell a, Cell b) { return a.Id() == b.Id(); }
+inline bool operator!=(Cell a, Cell b) { return a.Id() != b.Id(); }
+
+namespace std {
+template <>
+struct hash<Cell> {
+  std::size_t operator()(Cell cell) const noexcept {
+    // Fibonacci hashing spreads neighbouring cells across buckets.
+    return static_cast<std::size_t>(cell.Id() * 2654435769u);
+  }
+};
+}  // namespace std
+
+#endif /* CELL_H */
@@ -0,0 +1,168 @@
+#include <algorithm>
+#include "cell_hash_set.h"
+
+namespace {
+constexpr std::size_t kMinSlots{16};
+}
+
+/**
+ * @brief Finds the dense index of a cell.
+ *
+ * @param cell The cell to look up.
+ *
+ * @return The position of the cell in Cells(), or npos if the cell is not in the set.
+ */
+std::size_t CellHashSet::Find(Cell cell) const {
+  if (slots_.empty()) {
+    return npos;
+  }
+  std::size_t slot = FindSlot(cell.Id());
+  return (slots_[slot].index == kEmptySlot) ? npos : slots_[slot].index;
+}
+
+/**
+ * @brief Returns the slot holding a key, or the empty slot where it would be inserted.
+ *
+ * @param key The packed cell id.
+ *
+ * @return The slot position in the table.
+ */
+std::size_t CellHashSet::FindSlot(std::uint32_t key) const {
+  std::size_t slot = HomeSlot(key);
+  while (slots_[slot].index != kEmptySlot && slots_[slot].key != key) {
+    slot = (slot + 1) & mask_;
+  }
+  return slot;
+}
+
+/**
+ * @brief Adds a cell to the set.
+ *
+ * @param cell The cell to add.
+ *
+ * @return True if the cell was added, false if it was already in the set.
+ */
+bool CellHashSet::Insert(Cell cell) {
+  // Keep the table at most half full so probe sequences stay short.
+  if ((cells_.size() + 1) * 2 > slots_.size()) {
+    Rehash(std::max(kMinSlots, slots_.size() * 2));
+  }
+
+  std::uint32_t key = cell.Id();
+  std::size_t slot = FindSlot(key);
+  if (slots_[slot].index != kEmptySlot) {
+    return false;
+  }
+  slots_[slot] = Slot{key, static_cast<std::uint32_t>(cells_.size())};
+  cells_.push_back(cell);
+  return true;
+}
+
+/**
+ * @brief Removes a cell from the set.
+ *
+ * The last cell of the dense storage is moved into the freed position, and the table uses
+ * backward-shift deletion so that no tombstones are left behind.
+ *
+ * @param cell The cell to remove.
+ *
+ * @return True if the cell was removed, false if it was not in the set.
+ */
+bool CellHashSet::Erase(Cell cell) {
+  if (slots_.empty()) {
+    return false;
+  }
+  std::size_t slot = FindSlot(cell.Id());
+  if (slots_[slot].index == kEmptySlot) {
+    return false;
+  }
+
+  // Swap-remove from the dense storage and fix the slot of the moved cell.
+  std::uint32_t index = slots_[slot].index;
+  Cell last = cells_.back();
+  cells_[index] = last;
+  cells_.pop_back();
+  if (last != cell) {
+    slots_[FindSlot(last.Id())].index = index;
+  }
+
+  // Shift following entries of the probe chain back into the hole.
+  std::size_t hole = slot;
+  std::size_t next = (hole + 1) & mask_;
+  while (slots_[next].index != kEmptySlot) {
+    std::size_t home = HomeSlot(slots_[next].key);
+    if (((next - home) & mask_) >= ((next - hole) & mask_)) {
+      slots_[hole] = slots_[next];
+      hole = next;
+    }
+    next = (next + 1) & mask_;
+  }
+  slots_[hole].index = kEmptySlot;
+  return true;
+}
+
+/**
+ * @brief Replaces the set with a copy of another one.
+ *
+ * The copy takes at least the other set's reserved capacity, so copying the same set again as it
+ * changes, as frame snapshots do every tick, does not allocate until the other set grows.
+ *
+ * @param other The set to copy.
+ *
+ * @return This set.
+ */
+CellHashSet &CellHashSet::operator=(CellHashSet const &other) {
+  if (this != &other) {
+    cells_.reserve(other.cells_.capacity());
+    cells_.assign(other.cells_.begin(), other.cells_.end());
+    slots_.assign(other.slots_.begin(), other.slots_.end());
+    mask_ = other.mask_;
+    shift_ = other.shift_;
+  }
+  return *this;
+}
+
+/**
+ * @brief Removes every cell while keeping the allocated storage.
+ */
+void CellHashSet::Clear(void) {
+  cells_.clear();
+  for (auto &slot : slots_) {
+    slot.index = kEmptySlot;
+  }
+}
+
+/**
+ * @brief Pre-sizes the set so that count cells can be inserted without reallocating.
+ *
+ * @param count The number of cells expected.
+ */
+void CellHashSet::Reserve(std::size_t count) {
+  cells_.reserve(count);
+  std::size_t slot_count = kMinSlots;
+  while (slot_count < count * 2) {
+    slot_count *= 2;
+  }
+  if (slot_count > slots_.size()) {
+    Rehash(slot_count);
+  }
+}
+
+/**
+ * @brief Rebuilds the table with a new power-of-two number of slots.
+ *
+ * @param slot_count The new number of slots.
+ */
+void CellHashSet::Rehash(std::size_t slot_count) {
+  slots_.assign(slot_count, Slot{0, kEmptySlot});
+  mask_ = slot_count - 1;
+  shift_ = 64;
+  for (std::size_t n = slot_count; n > 1; n >>= 1) {
+    --shift_;
+  }
+
+  for (std::size_t i = 0; i < cells_.size(); ++i) {
+    std::uint32_t key = cells_[i].Id();
+    slots_[FindSlot(key)] = Slot{key, static_cast<std::uint32_t>(i)};
+  }
+}
@@ -0,0 +1,69 @@
+#ifndef CELL_HASH_SET_H
+#define CELL_HASH_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cell.h"
+
+/**
+ * @brief Sparse set of grid cells.
+ *
+ * Cells are kept in a dense vector for cache-friendly iteration, and an
+ * open-addressing (linear probing) table keyed on the packed cell id maps each
+ * cell to its position in that vector. Memory is proportional to the number of
+ * cells stored, not to the board size.
+ */
+class CellHashSet {
+ public:
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  CellHashSet() = default;
+  CellHashSet(CellHashSet const &other) = default;
+  CellHashSet(CellHashSet &&other) noexcept = default;
+  CellHashSet &operator=(CellHashSet const &other);
+  CellHashSet &operator=(CellHashSet &&other) noexcept = default;
+
+  bool Contains(Cell cell) const { return Find(cell) != npos; }
+  std::size_t Find(Cell cell) const;
+  bool Insert(Cell cell);
+  bool Erase(Cell cell);
+  void Clear(void);
+  void Reserve(std::size_t count);
+
+  template <typename Iterator>
+  void Assign(Iterator first, Iterator last) {
+    Clear();
+    for (; first != last; ++first) {
+      Insert(*first);
+    }
+  }
+
+  std::size_t Size(void) const { return cells_.size(); }
+  bool Empty(void) const { return cells_.empty(); }
+  std::vector<Cell> const &Cells(void) const { return cells_; }
+  std::vector<Cell>::const_iterator begin() const { return cells_.begin(); }
+  std::vector<Cell>::const_iterator end() const { return cells_.end(); }
+
+ private:
+  // A slot is empty when index is kEmptySlot; otherwise cells_[index].Id() == key.
+  struct Slot {
+    std::uint32_t key;
+    std::uint32_t index;
+  };
+  static constexpr std::uint32_t kEmptySlot{0xFFFFFFFFu};
+
+  std::vector<Cell> cells_;
+  std::vector<Slot> slots_;
+  std::size_t mask_{0};
+  unsigned shift_{64};
+
+  // Fibonacci hashing: the top bits of the product pick the home slot.
+  std::size_t HomeSlot(std::uint32_t key) const {
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_) & mask_;
+  }
+  std::size_t FindSlot(std::uint32_t key) const;
+  void Rehash(std::size_t slot_count);
+};
+
+#endif /* CELL_HASH_SET_H */
@@ -0,0 +1,67 @@
+#ifndef CELL_QUEUE_H
+#define CELL_QUEUE_H
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include "cell.h"
+
+/**
+ * @brief Contiguous FIFO of cells with amortised O(1) push_back and pop_front.
+ *
+ * Popped cells are skipped by moving a start offset; the live cells are moved
+ * back to the front of the storage only when the dead prefix grows as large as
+ * the live part. Storage is only allocated when the queue outgrows its
+ * capacity, so a snake that is not growing never allocates.
+ */
+class CellQueue {
+ public:
+  CellQueue() = default;
+  explicit CellQueue(std::size_t capacity) { storage_.reserve(capacity); }
+
+  void push_back(Cell cell) {
+    if (start_ > 0 && storage_.size() == storage_.capacity()) {
+      Compact();
+    }
+    storage_.push_back(cell);
+  }
+
+  void pop_front(void) {
+    start_++;
+    if (start_ == storage_.size()) {
+      storage_.clear();
+      start_ = 0;
+    } else if (start_ >= storage_.size() - start_) {
+      Compact();
+    }
+  }
+
+  void clear(void) {
+    storage_.clear();
+    start_ = 0;
+  }
+
+  void reserve(std::size_t capacity) { storage_.reserve(start_ + capacity); }
+
+  std::size_t size(void) const { return storage_.size() - start_; }
+  bool empty(void) const { return size() == 0; }
+  const Cell *data(void) const { return storage_.data() + start_; }
+  const Cell *begin(void) const { return data(); }
+  const Cell *end(void) const { return storage_.data() + storage_.size(); }
+  const Cell &operator[](std::size_t index) const { return storage_[start_ + index]; }
+  const Cell &front(void) const { return storage_[start_]; }
+  const Cell &back(void) const { return storage_.back(); }
+
+ private:
+  void Compact(void) {
+    std::size_t live = size();
+    std::memmove(storage_.data(), storage_.data() + start_, live * sizeof(Cell));
+    storage_.resize(live);
+    start_ = 0;
+  }
+
+  std::vector<Cell> storage_;
+  std::size_t start_{0};
+};
+
+#endif /* CELL_QUEUE_H */
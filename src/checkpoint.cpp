@@ -0,0 +1,451 @@
+#include "checkpoint.h"
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+constexpr std::uint32_t kMagic{0x334B4353u};  // "SCK3"
+
+enum RecordType : std::uint8_t {
+  kFull = 1,
+  kDelta = 2
+};
+
+enum RecordFlags : std::uint8_t {
+  kHasObstacles = 1 << 0,
+  kHasEngine = 1 << 1,
+  kHasItems = 1 << 2
+};
+
+struct RecordHeader {
+  std::uint32_t magic;
+  std::uint8_t type;
+  std::uint8_t flags;
+  std::uint16_t reserved;
+  std::uint32_t size;  // Payload bytes after the header
+  std::uint32_t crc;   // CRC-32 of the payload
+};
+
+std::uint32_t Crc32(const std::uint8_t *data, std::size_t size) {
+  static const std::array<std::uint32_t, 256> table = [] {
+    std::array<std::uint32_t, 256> entries{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+      std::uint32_t crc = i;
+      for (int bit = 0; bit < 8; ++bit) {
+        crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+      }
+      entries[i] = crc;
+    }
+    return entries;
+  }();
+  std::uint32_t crc = 0xFFFFFFFFu;
+  for (std::size_t i = 0; i < size; ++i) {
+    crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename T>
+void Put(std::vector<std::uint8_t> &out, const T &value) {
+  const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(&value);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+void PutCells(std::vector<std::uint8_t> &out, const Cell *cells, std::size_t count) {
+  Put(out, static_cast<std::uint32_t>(count));
+  const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(cells);
+  out.insert(out.end(), bytes, bytes + count * sizeof(Cell));
+}
+
+void PutItems(std::vector<std::uint8_t> &out, const std::vector<Item_t> &items) {
+  Put(out, static_cast<std::uint32_t>(items.size()));
+  const std::uint8_t *bytes = reinterpret_cast<const std::uint8_t *>(items.data());
+  out.insert(out.end(), bytes, bytes + items.size() * sizeof(Item_t));
+}
+
+void PutEngine(std::vector<std::uint8_t> &out, const std::mt19937 &engine) {
+  std::ostringstream text;
+  text << engine;
+  std::string const state = text.str();
+  Put(out, static_cast<std::uint32_t>(state.size()));
+  out.insert(out.end(), state.begin(), state.end());
+}
+
+// Bounds-checked reads from a record payload; a failed read leaves ok false.
+struct PayloadReader {
+  const std::uint8_t *data;
+  std::size_t size;
+  std::size_t offset{0};
+  bool ok{true};
+
+  template <typename T>
+  T Get(void) {
+    T value{};
+    if (!ok || size - offset < sizeof(T)) {
+      ok = false;
+      return value;
+    }
+    std::memcpy(&value, data + offset, sizeof(T));
+    offset += sizeof(T);
+    return value;
+  }
+
+  const Cell *GetCells(std::size_t &count) {
+    count = Get<std::uint32_t>();
+    if (!ok || (size - offset) / sizeof(Cell) < count) {
+      ok = false;
+      count = 0;
+      return nullptr;
+    }
+    const Cell *cells = reinterpret_cast<const Cell *>(data + offset);
+    offset += count * sizeof(Cell);
+    return cells;
+  }
+
+  bool GetItems(std::vector<Item_t> &items) {
+    std::uint32_t count = Get<std::uint32_t>();
+    if (!ok || (size - offset) / sizeof(Item_t) < count) return ok = false;
+    items.resize(count);
+    std::memcpy(items.data(), data + offset, count * sizeof(Item_t));
+    offset += count * sizeof(Item_t);
+    for (Item_t const &item : items) {
+      if (static_cast<std::size_t>(item.kind) >= kItemKinds) return ok = false;
+    }
+    return true;
+  }
+
+  bool GetEngine(std::mt19937 &engine) {
+    std::uint32_t length = Get<std::uint32_t>();
+    if (!ok || size - offset < length) return ok = false;
+    std::istringstream text(std::string(reinterpret_cast<const char *>(data + offset), length));
+    text >> engine;
+    offset += length;
+    return ok = !text.fail();
+  }
+};
+
+/**
+ * @brief Applies new body cells and the tail index to a body copy.
+ *
+ * @param body The body copy.
+ * @param body_first Index of the first cell of the body copy; updated.
+ * @param first_cell Index of the first new cell.
+ * @param cells The new cells.
+ * @param count The number of new cells.
+ * @param cells_added Total number of cells the snake has appended.
+ * @param body_size Number of cells in the snake's body.
+ */
+void ApplyCells(CellQueue &body, std::uint64_t &body_first, std::uint64_t first_cell, const Cell *cells,
+                std::size_t count, std::uint64_t cells_added, std::uint64_t body_size) {
+  if (count > 0 && first_cell != body_first + body.size()) {
+    // Cells between the copy and the new ones were dropped before they were captured.
+    body.clear();
+    body_first = first_cell;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    body.push_back(cells[i]);
+  }
+  std::uint64_t const tail = cells_added - body_size;
+  while (body_first < tail && !body.empty()) {
+    body.pop_front();
+    body_first++;
+  }
+  if (body.empty()) {
+    body_first = cells_added;
+  }
+}
+
+/**
+ * @brief Fills in the header reserved at the start of a record.
+ *
+ * @param record The record; its payload follows the header.
+ * @param type The record type.
+ * @param flags The parts present in the payload.
+ */
+void FinishRecord(std::vector<std::uint8_t> &record, std::uint8_t type, std::uint8_t flags) {
+  std::size_t const payload = record.size() - sizeof(RecordHeader);
+  RecordHeader header{kMagic, type, flags, 0, static_cast<std::uint32_t>(payload),
+                      Crc32(record.data() + sizeof(RecordHeader), payload)};
+  std::memcpy(record.data(), &header, sizeof(header));
+}
+}  // namespace
+
+namespace CheckpointRecord {
+
+/**
+ * @brief Encodes the changes taken from a game as a delta record.
+ *
+ * @param record Receives the record; its storage is reused.
+ * @param delta The changes.
+ */
+void EncodeDelta(std::vector<std::uint8_t> &record, const CheckpointDelta_t &delta) {
+  record.assign(sizeof(RecordHeader), 0);
+  Put(record, delta.scalars);
+  Put(record, delta.first_cell);
+  PutCells(record, delta.new_cells.data(), delta.new_cells.size());
+  if (delta.obstacles_changed) PutCells(record, delta.obstacles.data(), delta.obstacles.size());
+  if (delta.items_changed) PutItems(record, delta.items);
+  if (delta.engine_changed) PutEngine(record, delta.engine);
+  FinishRecord(record, kDelta,
+               (delta.obstacles_changed ? kHasObstacles : 0) | (delta.items_changed ? kHasItems : 0) |
+                   (delta.engine_changed ? kHasEngine : 0));
+}
+
+}  // namespace CheckpointRecord
+
+/**
+ * @brief Applies the record at the start of a buffer.
+ *
+ * A delta applied to an empty state must hold the whole body, as the first capture of a game
+ * does; restoring from a file requires a full record first.
+ *
+ * @param data The buffer.
+ * @param available The number of bytes in the buffer.
+ * @param record_size Receives the size of the record, header included.
+ * @param full Receives whether it was a full record.
+ *
+ * @return False, leaving the state unchanged, if the buffer does not start with a complete,
+ *         valid record.
+ */
+bool CheckpointState::Apply(const std::uint8_t *data, std::size_t available, std::size_t &record_size, bool &full) {
+  if (available < sizeof(RecordHeader)) return false;
+  RecordHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  const std::uint8_t *payload = data + sizeof(header);
+  if (header.magic != kMagic || (header.type != kFull && header.type != kDelta) ||
+      available - sizeof(header) < header.size || Crc32(payload, header.size) != header.crc) {
+    return false;
+  }
+
+  PayloadReader reader{payload, header.size};
+  CheckpointScalars_t const next = reader.Get<CheckpointScalars_t>();
+  std::uint64_t const first_cell = reader.Get<std::uint64_t>();
+  std::size_t cell_count = 0;
+  const Cell *cells = reader.GetCells(cell_count);
+  std::size_t obstacle_count = 0;
+  const Cell *next_obstacles = (header.flags & kHasObstacles) ? reader.GetCells(obstacle_count) : nullptr;
+  std::vector<Item_t> next_items;
+  if (header.flags & kHasItems) reader.GetItems(next_items);
+  std::mt19937 next_engine;
+  if (header.flags & kHasEngine) reader.GetEngine(next_engine);
+  if (!reader.ok || next.size < 1 || next.grid_width == 0 || next.grid_height == 0 ||
+      next.grid_width > Cell::kMaxGridSide || next.grid_height > Cell::kMaxGridSide) {
+    return false;
+  }
+
+  scalars = next;
+  if (header.type == kFull) {
+    body.clear();
+    body_first = first_cell;
+  }
+  ApplyCells(body, body_first, first_cell, cells, cell_count, scalars.cells_added,
+             static_cast<std::uint64_t>(scalars.size) - 1);
+  if (header.flags & kHasObstacles) obstacles.assign(next_obstacles, next_obstacles + obstacle_count);
+  if (header.flags & kHasItems) std::swap(items, next_items);
+  if (header.flags & kHasEngine) engine = next_engine;
+  record_size = sizeof(header) + header.size;
+  full = (header.type == kFull);
+  return true;
+}
+
+/**
+ * @brief Encodes the whole state as a full record.
+ *
+ * @param record Receives the record; its storage is reused.
+ */
+void CheckpointState::EncodeFull(std::vector<std::uint8_t> &record) const {
+  record.assign(sizeof(RecordHeader), 0);
+  Put(record, scalars);
+  Put(record, body_first);
+  PutCells(record, body.data(), body.size());
+  PutCells(record, obstacles.data(), obstacles.size());
+  PutItems(record, items);
+  PutEngine(record, engine);
+  FinishRecord(record, kFull, kHasObstacles | kHasItems | kHasEngine);
+}
+
+/**
+ * @brief Copies the state out.
+ *
+ * @param state Receives the state.
+ */
+void CheckpointState::Get(GameState_t &state) const {
+  state.scalars = scalars;
+  state.body.assign(body.begin(), body.end());
+  state.obstacles = obstacles;
+  state.items = items;
+  state.engine = engine;
+}
+
+/**
+ * @brief Opens the checkpoint file and starts the writer thread.
+ *
+ * Nothing is written until the first capture, which becomes the first full record.
+ *
+ * @param path The checkpoint file; it is replaced.
+ */
+CheckpointWriter::CheckpointWriter(const std::string &path) : path(path) {
+  writer_thread = std::thread(&CheckpointWriter::WriterLoop, this);
+}
+/**
+ * @brief Writes the pending changes and stops the writer thread.
+ */
+CheckpointWriter::~CheckpointWriter() {
+  Finish();
+}
+
+/**
+ * @brief Locks the pending changes for the game to update; must be followed by EndCapture().
+ *
+ * @return The pending changes.
+ */
+CheckpointDelta_t &CheckpointWriter::BeginCapture(void) {
+  mtx.lock();
+  return pending;
+}
+
+/**
+ * @brief Releases the pending changes and wakes the writer thread.
+ */
+void CheckpointWriter::EndCapture(void) {
+  pending.captured = true;
+  mtx.unlock();
+  cv.notify_one();
+}
+
+/**
+ * @brief Writes whatever was captured and stops the writer thread. Later captures are not written.
+ */
+void CheckpointWriter::Finish(void) {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping = true;
+  }
+  cv.notify_one();
+  if (writer_thread.joinable()) {
+    writer_thread.join();
+  }
+  if (file != nullptr) {
+    std::fclose(file);
+    file = nullptr;
+  }
+}
+
+/**
+ * @brief Writer thread: takes the pending changes and writes them as a record.
+ *
+ * Taking the changes swaps buffers under the lock, so the game is only blocked for as long as
+ * the swap takes.
+ */
+void CheckpointWriter::WriterLoop(void) {
+  std::unique_lock<std::mutex> lock(mtx);
+  while (true) {
+    cv.wait(lock, [this] { return stopping || pending.captured; });
+    if (!pending.captured) break;
+
+    writing.scalars = pending.scalars;
+    writing.first_cell = pending.first_cell;
+    writing.new_cells.clear();
+    std::swap(writing.new_cells, pending.new_cells);
+    writing.obstacles_changed = pending.obstacles_changed;
+    if (pending.obstacles_changed) {
+      std::swap(writing.obstacles, pending.obstacles);
+    }
+    writing.items_changed = pending.items_changed;
+    if (pending.items_changed) {
+      std::swap(writing.items, pending.items);
+    }
+    writing.engine_changed = pending.engine_changed;
+    if (pending.engine_changed) {
+      writing.engine = pending.engine;
+    }
+    pending.captured = false;
+    pending.obstacles_changed = false;
+    pending.items_changed = false;
+    pending.engine_changed = false;
+    lock.unlock();
+
+    CheckpointRecord::EncodeDelta(record, writing);
+    std::size_t record_size;
+    bool full;
+    state.Apply(record.data(), record.size(), record_size, full);
+    if (!has_full || deltas_since_full >= kDeltasPerFull) {
+      state.EncodeFull(record);
+      WriteFull();
+    } else {
+      WriteDelta();
+    }
+
+    lock.lock();
+  }
+}
+
+/**
+ * @brief Appends the delta record to the checkpoint file.
+ */
+void CheckpointWriter::WriteDelta(void) {
+  if (file == nullptr) return;
+  std::fwrite(record.data(), 1, record.size(), file);
+  std::fflush(file);
+  deltas_since_full++;
+}
+
+/**
+ * @brief Replaces the checkpoint file with the full record of the writer's copy of the state.
+ *
+ * The record is written to a temporary file that is then renamed, so a crash leaves either the
+ * old or the new file complete. Later deltas are appended to the new file.
+ */
+void CheckpointWriter::WriteFull(void) {
+  std::string const temporary = path + ".tmp";
+  std::FILE *next = std::fopen(temporary.c_str(), "wb");
+  if (next == nullptr) return;
+  bool written = std::fwrite(record.data(), 1, record.size(), next) == record.size() && std::fflush(next) == 0;
+  if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::fclose(next);
+    std::remove(temporary.c_str());
+    return;
+  }
+  if (file != nullptr) {
+    std::fclose(file);
+  }
+  file = next;
+  has_full = true;
+  deltas_since_full = 0;
+}
+
+/**
+ * @brief Restores the latest state stored in a checkpoint file.
+ *
+ * Records are replayed from the full record at the start of the file. Replay stops at the first
+ * truncated or corrupt record, so a file cut short by a crash restores the last complete state.
+ *
+ * @param path The checkpoint file.
+ * @param state Receives the restored state.
+ *
+ * @return True if at least the full record was valid.
+ */
+bool CheckpointWriter::Load(const std::string &path, GameState_t &state) {
+  std::ifstream input(path, std::ios::binary);
+  if (!input) return false;
+  std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+  CheckpointState restored_state;
+  bool restored = false;
+  std::size_t offset = 0;
+  std::size_t record_size;
+  bool full;
+  while (restored_state.Apply(data.data() + offset, data.size() - offset, record_size, full)) {
+    if (!restored && !full) break;
+    restored = true;
+    offset += record_size;
+  }
+
+  if (restored) {
+    restored_state.Get(state);
+  }
+  return restored;
+}
@@ -0,0 +1,153 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cell.h"
+#include "cell_queue.h"
+#include "item_board.h"
+
+/**
+ * @brief Scalar part of a game's state, shared by full and delta checkpoints.
+ */
+typedef struct CheckpointScalars {
+  std::uint64_t tick{0};
+  std::int32_t level{1};
+  std::uint32_t grid_width{0};  // Up to Cell::kMaxGridSide, which does not fit 16 bits
+  std::uint32_t grid_height{0};
+  Cell head;
+  float progress{0.0f};
+  float speed{0.0f};
+  std::uint8_t direction{0};
+  std::uint8_t alive{1};
+  std::uint8_t growing{0};
+  std::uint8_t turned_in_cell{0};
+  std::int32_t size{1};
+  std::int32_t score{0};
+  std::uint64_t cells_added{0};  // Snake::cells_added; the body holds cells [cells_added - size of body, cells_added)
+  std::uint32_t obstacle_version{0};
+  std::uint32_t item_version{0};
+  std::uint64_t boost_until{0};  // Tick on which the speed power-up wears off, if later than tick
+  std::uint64_t ghost_until{0};  // Tick on which the ghost power-up wears off, if later than tick
+} CheckpointScalars_t;
+
+/**
+ * @brief Everything needed to rebuild a game exactly, as restored from a checkpoint file.
+ */
+typedef struct GameState {
+  CheckpointScalars_t scalars;
+  std::vector<Cell> body;
+  std::vector<Cell> obstacles;
+  std::vector<Item_t> items;
+  std::mt19937 engine;
+} GameState_t;
+
+/**
+ * @brief Changes captured since the checkpoint writer last took them.
+ *
+ * Filled by the game under CheckpointWriter::BeginCapture(); captures
+ * accumulate until the writer thread takes them, so the game never waits for
+ * the disk and a capture only copies what changed.
+ */
+typedef struct CheckpointDelta {
+  CheckpointScalars_t scalars;
+  std::uint64_t first_cell{0};         // Index of new_cells[0]
+  std::vector<Cell> new_cells;         // Body cells appended since the last capture
+  bool obstacles_changed{false};
+  std::vector<Cell> obstacles;
+  bool items_changed{false};
+  std::vector<Item_t> items;
+  bool engine_changed{false};
+  std::mt19937 engine;
+  // Capture bookkeeping, kept when the writer takes the changes.
+  bool captured{false};                // Something was captured since the writer last took it
+  std::uint64_t next_cell{0};          // Next body cell index the writer has not seen
+  std::uint32_t seen_obstacle_version{0xFFFFFFFFu};
+  std::uint32_t seen_item_version{0xFFFFFFFFu};
+  std::uint32_t seen_engine_version{0xFFFFFFFFu};
+} CheckpointDelta_t;
+
+// Encodes the changes of a delta as one delta record.
+namespace CheckpointRecord {
+void EncodeDelta(std::vector<std::uint8_t> &record, const CheckpointDelta_t &delta);
+}
+
+/**
+ * @brief A game state rebuilt from checkpoint records.
+ *
+ * A record has a header holding its type, size and CRC-32. A full record
+ * holds the whole state; a delta record only holds what changed: scalars, new
+ * body cells and the tail index, and the obstacles, items or RNG engine when
+ * they changed. Applying deltas keeps the copy up to date without ever copying the
+ * whole body, and EncodeFull() writes the copy back as a full record.
+ */
+class CheckpointState {
+ public:
+  bool Apply(const std::uint8_t *data, std::size_t available, std::size_t &record_size, bool &full);
+  void EncodeFull(std::vector<std::uint8_t> &record) const;
+  void Get(GameState_t &state) const;
+  std::uint64_t Tick(void) const { return scalars.tick; }
+
+ private:
+  CheckpointScalars_t scalars;
+  CellQueue body{1024};
+  std::uint64_t body_first{0};
+  std::vector<Cell> obstacles;
+  std::vector<Item_t> items;
+  std::mt19937 engine;
+};
+
+/**
+ * @brief Writes checkpoints of one game to a file on a background thread.
+ *
+ * The file starts with a full record, followed by delta records. The writer
+ * keeps its own CheckpointState, built from the deltas, and every
+ * kDeltasPerFull deltas rewrites the file as a single full record (written to
+ * a temporary file and renamed), so the file stays small and the game thread
+ * never copies the whole body.
+ */
+class CheckpointWriter {
+ public:
+  static constexpr int kDeltasPerFull{20};
+
+  explicit CheckpointWriter(const std::string &path);
+  ~CheckpointWriter();
+
+  CheckpointWriter(const CheckpointWriter &other) = delete;
+  CheckpointWriter &operator=(const CheckpointWriter &other) = delete;
+
+  CheckpointDelta_t &BeginCapture(void);
+  void EndCapture(void);
+  void Finish(void);
+
+  static bool Load(const std::string &path, GameState_t &state);
+
+ private:
+  std::string path;
+  std::FILE *file{nullptr};
+
+  CheckpointDelta_t pending;
+  CheckpointDelta_t writing;
+  std::thread writer_thread;
+  std::mutex mtx;
+  std::condition_variable cv;
+  bool stopping{false};
+
+  // The writer's copy of the state.
+  CheckpointState state;
+  int deltas_since_full{0};
+  bool has_full{false};
+  std::vector<std::uint8_t> record;
+
+  void WriterLoop(void);
+  void WriteDelta(void);
+  void WriteFull(void);
+};
+
+#endif /* CHECKPOINT_H */
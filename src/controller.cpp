@@ -1,41 +1,210 @@
 #include "controller.h"
+#include <cerrno>
 #include <iostream>
+#include <poll.h>
+#include <unistd.h>
 #include "SDL.h"
 #include "snake.h"
 
-void Controller::ChangeDirection(Snake &snake, Snake::Direction input,
-                                 Snake::Direction opposite) const {
-  if (snake.direction != opposite || snake.size == 1) snake.direction = input;
-  return;
+/**
+ * @brief Registers the key watcher, or puts the terminal in raw mode.
+ *
+ * SDL calls the watcher as soon as each event is queued, so key presses are captured with their
+ * own timestamps instead of being sampled once per frame. In the terminal, keys are read without
+ * echo or line buffering, and without blocking, once per frame.
+ *
+ * @param terminal True to read keys from the terminal instead of the SDL window.
+ */
+Controller::Controller(bool terminal) : terminal(terminal) {
+  if (!terminal) {
+    SDL_AddEventWatch(&Controller::CaptureKey, this);
+    return;
+  }
+  tcgetattr(STDIN_FILENO, &saved_termios);
+  struct termios raw = saved_termios;
+  raw.c_lflag &= ~(ICANON | ECHO | ISIG);
+  raw.c_cc[VMIN] = 0;
+  raw.c_cc[VTIME] = 0;
+  tcsetattr(STDIN_FILENO, TCSANOW, &raw);
 }
 
-void Controller::HandleInput(bool &running, Snake &snake) const {
+Controller::~Controller() {
+  if (terminal) {
+    tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+  } else {
+    SDL_DelEventWatch(&Controller::CaptureKey, this);
+  }
+}
+
+/**
+ * @brief Event watcher turning arrow key presses into queued turn commands, Backspace into rewinds
+ * and P or Space into pauses.
+ *
+ * Key repeats are ignored. When the queue is full the press is dropped.
+ *
+ * @param userdata The Controller that registered the watcher.
+ * @param event The event being queued.
+ *
+ * @return Always 0; the return value of an event watcher is ignored by SDL.
+ */
+int Controller::CaptureKey(void *userdata, SDL_Event *event) {
+  if (event->type != SDL_KEYDOWN || event->key.repeat) return 0;
+
+  Controller *controller = static_cast<Controller *>(userdata);
+  InputCommand_t command{Snake::Direction::kUp, event->key.timestamp};
+  switch (event->key.keysym.sym) {
+    case SDLK_UP:
+      command.direction = Snake::Direction::kUp;
+      break;
+
+    case SDLK_DOWN:
+      command.direction = Snake::Direction::kDown;
+      break;
+
+    case SDLK_LEFT:
+      command.direction = Snake::Direction::kLeft;
+      break;
+
+    case SDLK_RIGHT:
+      command.direction = Snake::Direction::kRight;
+      break;
+
+    case SDLK_BACKSPACE:
+      command.rewind = true;
+      break;
+
+    case SDLK_p:
+    case SDLK_SPACE:
+      command.pause = true;
+      break;
+
+    default:
+      return 0;
+  }
+  controller->commands.Push(command);
+  return 0;
+}
+
+void Controller::HandleInput(bool &running) {
+  if (terminal) {
+    ReadTerminal(running);
+    return;
+  }
+
+  // Polling pumps the SDL event queue, which runs CaptureKey for key presses.
   SDL_Event e;
   while (SDL_PollEvent(&e)) {
     if (e.type == SDL_QUIT) {
       running = false;
-    } else if (e.type == SDL_KEYDOWN) {
-      switch (e.key.keysym.sym) {
-        case SDLK_UP:
-          ChangeDirection(snake, Snake::Direction::kUp,
-                          Snake::Direction::kDown);
-          break;
+    }
+  }
+}
 
-        case SDLK_DOWN:
-          ChangeDirection(snake, Snake::Direction::kDown,
-                          Snake::Direction::kUp);
-          break;
+/**
+ * @brief Blocks until the player does something, then handles the input as HandleInput() does.
+ *
+ * Used while the game is paused or over, so that an idle game uses no CPU. Any window event
+ * ends the wait, so the caller can redraw an exposed or resized window.
+ *
+ * @param running Set to false when the player quits.
+ */
+void Controller::WaitInput(bool &running) {
+  if (terminal) {
+    struct pollfd input {STDIN_FILENO, POLLIN, 0};
+    int ready;
+    do {
+      ready = poll(&input, 1, -1);
+    } while (ready < 0 && errno == EINTR);
+    ReadTerminal(running);
+    return;
+  }
 
-        case SDLK_LEFT:
-          ChangeDirection(snake, Snake::Direction::kLeft,
-                          Snake::Direction::kRight);
-          break;
+  // Waiting pumps the SDL event queue, which runs CaptureKey for key presses.
+  SDL_Event e;
+  if (SDL_WaitEvent(&e) && e.type == SDL_QUIT) {
+    running = false;
+  }
+  HandleInput(running);
+}
+
+/**
+ * @brief Reads the keys typed in the terminal since the last frame.
+ *
+ * Arrow keys (ESC [ A-D or ESC O A-D) and WASD queue turns, Backspace a rewind, p or Space a
+ * pause; q or Ctrl-C quits. An escape sequence split across two reads is completed on the next one.
+ *
+ * @param running Set to false when the player quits.
+ */
+void Controller::ReadTerminal(bool &running) {
+  char keys[64];
+  ssize_t count;
+  while ((count = read(STDIN_FILENO, keys, sizeof(keys))) > 0) {
+    for (ssize_t i = 0; i < count; ++i) {
+      char const key = keys[i];
+      InputCommand_t command{Snake::Direction::kUp, SDL_GetTicks()};
+
+      if (escape_length == 1) {
+        escape_length = (key == '[' || key == 'O') ? 2 : 0;
+        if (escape_length == 2) continue;
+      } else if (escape_length == 2) {
+        escape_length = 0;
+        switch (key) {
+          case 'A':
+            command.direction = Snake::Direction::kUp;
+            break;
+          case 'B':
+            command.direction = Snake::Direction::kDown;
+            break;
+          case 'C':
+            command.direction = Snake::Direction::kRight;
+            break;
+          case 'D':
+            command.direction = Snake::Direction::kLeft;
+            break;
+          default:
+            continue;
+        }
+        commands.Push(command);
+        continue;
+      }
 
-        case SDLK_RIGHT:
-          ChangeDirection(snake, Snake::Direction::kRight,
-                          Snake::Direction::kLeft);
+      switch (key) {
+        case '\x1b':
+          escape_length = 1;
+          break;
+        case 'w':
+          command.direction = Snake::Direction::kUp;
+          commands.Push(command);
+          break;
+        case 's':
+          command.direction = Snake::Direction::kDown;
+          commands.Push(command);
+          break;
+        case 'a':
+          command.direction = Snake::Direction::kLeft;
+          commands.Push(command);
+          break;
+        case 'd':
+          command.direction = Snake::Direction::kRight;
+          commands.Push(command);
+          break;
+        case '\x7f':
+        case '\b':
+          command.rewind = true;
+          commands.Push(command);
+          break;
+        case 'p':
+        case ' ':
+          command.pause = true;
+          commands.Push(command);
+          break;
+        case 'q':
+        case '\x03':
+          running = false;
+          break;
+        default:
           break;
       }
     }
   }
-}
\ No newline at end of file
+}
@@ -1,15 +1,42 @@
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
 
+#include <termios.h>
+#include "SDL.h"
 #include "snake.h"
+#include "spsc_queue.h"
+
+// A turn requested by the player, stamped with the SDL event time in ms, or a rewind or pause.
+typedef struct InputCommand {
+  Snake::Direction direction;
+  Uint32 timestamp;
+  bool rewind{false};
+  bool pause{false};  // Pauses, or resumes a paused game
+} InputCommand_t;
+
+typedef SpscQueue<InputCommand_t, 64> InputQueue;
 
 class Controller {
  public:
-  void HandleInput(bool &running, Snake &snake) const;
+  explicit Controller(bool terminal = false);
+  ~Controller();
+
+  Controller(const Controller &other) = delete;
+  Controller &operator=(const Controller &other) = delete;
+
+  void HandleInput(bool &running);
+  void WaitInput(bool &running);
+  InputQueue &Commands(void) { return commands; }
 
  private:
-  void ChangeDirection(Snake &snake, Snake::Direction input,
-                       Snake::Direction opposite) const;
+  static int CaptureKey(void *userdata, SDL_Event *event);
+  void ReadTerminal(bool &running);
+
+  InputQueue commands;
+  // Keys are read from the terminal in raw mode instead of from SDL events.
+  bool terminal;
+  struct termios saved_termios {};
+  int escape_length{0};  // Bytes of an arrow key's escape sequence read so far
 };
 
-#endif
\ No newline at end of file
+#endif
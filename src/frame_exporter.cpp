@@ -0,0 +1,227 @@
+#include "frame_exporter.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+constexpr std::size_t kJobsPerEncoder{2};
+
+typedef struct Color {
+  std::uint8_t r, g, b;
+} Color_t;
+
+// Same colours as Renderer::Render.
+constexpr Color_t kBackground{0x1E, 0x1E, 0x1E};
+constexpr Color_t kFood{0xFF, 0xCC, 0x00};
+constexpr Color_t kObstacle{0xA9, 0xA9, 0xA9};
+constexpr Color_t kBody{0xFF, 0xFF, 0xFF};
+constexpr Color_t kHead{0x00, 0x7A, 0xCC};
+constexpr Color_t kDeadHead{0xFF, 0x00, 0x00};
+// Indexed by ItemKind.
+constexpr Color_t kItems[kItemKinds]{kFood, {0x00, 0xE5, 0xFF}, {0xFF, 0x3E, 0xD0}, {0xB3, 0x9D, 0xDB}};
+}  // namespace
+
+/**
+ * @brief Creates the exporter and starts its encoder threads.
+ *
+ * @param directory The existing directory the images are written to.
+ * @param screen_width The image width in pixels, as for Renderer.
+ * @param screen_height The image height in pixels, as for Renderer.
+ * @param grid_width The width of the board in cells.
+ * @param grid_height The height of the board in cells.
+ * @param viewport_width The number of cells shown per row, clamped to the board width.
+ * @param viewport_height The number of cells shown per column, clamped to the board height.
+ * @param thread_count The number of encoder threads; at least one is started.
+ */
+FrameExporter::FrameExporter(const std::string &directory, std::size_t screen_width, std::size_t screen_height,
+                             std::size_t grid_width, std::size_t grid_height, std::size_t viewport_width,
+                             std::size_t viewport_height, std::size_t thread_count)
+    : directory(directory),
+      grid_width(static_cast<int>(grid_width)),
+      grid_height(static_cast<int>(grid_height)),
+      viewport_width(static_cast<int>(std::min(viewport_width, grid_width))),
+      viewport_height(static_cast<int>(std::min(viewport_height, grid_height))) {
+  cell_width = std::max(1, static_cast<int>(screen_width) / this->viewport_width);
+  cell_height = std::max(1, static_cast<int>(screen_height) / this->viewport_height);
+
+  thread_count = std::max<std::size_t>(thread_count, 1);
+  jobs.resize(thread_count * kJobsPerEncoder);
+  for (std::size_t i = 0; i < jobs.size(); ++i) {
+    free_jobs.push_back(i);
+  }
+  for (std::size_t i = 0; i < thread_count; ++i) {
+    encoders.emplace_back(&FrameExporter::EncoderLoop, this);
+  }
+}
+
+/**
+ * @brief Writes the remaining frames and stops the encoder threads.
+ */
+FrameExporter::~FrameExporter() {
+  Finish();
+}
+
+/**
+ * @brief Queues a snapshot for export.
+ *
+ * Blocks while every slot is still being encoded. The snapshot is copied, so the caller may
+ * reuse it as soon as this returns.
+ *
+ * @param frame The snapshot to export.
+ */
+void FrameExporter::Export(FrameSnapshot_t const &frame) {
+  std::unique_lock<std::mutex> lock(mtx);
+  cv_free.wait(lock, [this] { return !free_jobs.empty(); });
+  std::size_t index = free_jobs.front();
+  free_jobs.pop_front();
+  lock.unlock();
+
+  // The slot is owned by this thread until it is queued.
+  Job_t &job = jobs[index];
+  job.number = next_number++;
+  job.frame.tick = frame.tick;
+  job.frame.body.assign(frame.body.begin(), frame.body.end());
+  job.frame.body_cells = frame.body_cells;
+  job.frame.head = frame.head;
+  job.frame.alive = frame.alive;
+  if (job.frame.item_version != frame.item_version) {
+    job.frame.items = frame.items;
+    job.frame.item_version = frame.item_version;
+  }
+  if (job.frame.obstacle_version != frame.obstacle_version) {
+    job.frame.obstacles = frame.obstacles;
+    job.frame.obstacle_version = frame.obstacle_version;
+  }
+  job.frame.score = frame.score;
+  job.frame.size = frame.size;
+
+  lock.lock();
+  ready_jobs.push_back(index);
+  lock.unlock();
+  cv_ready.notify_one();
+}
+
+/**
+ * @brief Waits until every queued frame is written, then stops the encoder threads.
+ */
+void FrameExporter::Finish(void) {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    stopping = true;
+  }
+  cv_ready.notify_all();
+  for (auto &encoder : encoders) {
+    if (encoder.joinable()) {
+      encoder.join();
+    }
+  }
+}
+
+/**
+ * @brief Encoder thread: rasterises and writes queued frames until Finish() drains the queue.
+ */
+void FrameExporter::EncoderLoop(void) {
+  std::vector<std::uint8_t> pixels;
+  std::unique_lock<std::mutex> lock(mtx);
+  while (true) {
+    cv_ready.wait(lock, [this] { return stopping || !ready_jobs.empty(); });
+    if (ready_jobs.empty()) break;
+    std::size_t index = ready_jobs.front();
+    ready_jobs.pop_front();
+    lock.unlock();
+
+    Rasterize(jobs[index].frame, pixels);
+    bool ok = WriteImage(jobs[index].number, pixels);
+
+    lock.lock();
+    ok ? written++ : failed++;
+    free_jobs.push_back(index);
+    cv_free.notify_one();
+  }
+}
+
+/**
+ * @brief Draws a snapshot into an RGB image, one solid block per cell.
+ *
+ * The camera follows the head like Renderer::UpdateCamera, and cells outside the viewport are
+ * skipped.
+ *
+ * @param frame The snapshot to draw.
+ * @param pixels The image to fill; resized to the image size.
+ */
+void FrameExporter::Rasterize(FrameSnapshot_t const &frame, std::vector<std::uint8_t> &pixels) const {
+  int const image_width = viewport_width * cell_width;
+  int const image_height = viewport_height * cell_height;
+  pixels.resize(static_cast<std::size_t>(image_width) * image_height * 3);
+  for (std::size_t i = 0; i < pixels.size(); i += 3) {
+    pixels[i] = kBackground.r;
+    pixels[i + 1] = kBackground.g;
+    pixels[i + 2] = kBackground.b;
+  }
+
+  int const camera_x = (viewport_width < grid_width) ? (frame.head.x - viewport_width / 2 + grid_width) % grid_width : 0;
+  int const camera_y = (viewport_height < grid_height) ? (frame.head.y - viewport_height / 2 + grid_height) % grid_height : 0;
+
+  auto fill = [&](Cell const &cell, Color_t const &color) {
+    int const view_x = (cell.x - camera_x + grid_width) % grid_width;
+    int const view_y = (cell.y - camera_y + grid_height) % grid_height;
+    if (view_x >= viewport_width || view_y >= viewport_height) return;
+    for (int y = 0; y < cell_height; ++y) {
+      std::uint8_t *row = &pixels[((static_cast<std::size_t>(view_y) * cell_height + y) * image_width +
+                                   static_cast<std::size_t>(view_x) * cell_width) * 3];
+      for (int x = 0; x < cell_width; ++x) {
+        row[x * 3] = color.r;
+        row[x * 3 + 1] = color.g;
+        row[x * 3 + 2] = color.b;
+      }
+    }
+  };
+
+  for (Item_t const &item : frame.items) {
+    fill(item.cell, kItems[static_cast<std::size_t>(item.kind)]);
+  }
+  // Like Renderer::CollectCells, probe the visible tiles when a set holds more cells than tiles.
+  auto fill_set = [&](CellHashSet const &cells, Color_t const &color) {
+    if (cells.Size() > static_cast<std::size_t>(viewport_width) * viewport_height) {
+      for (int view_y = 0; view_y < viewport_height; ++view_y) {
+        for (int view_x = 0; view_x < viewport_width; ++view_x) {
+          Cell cell((camera_x + view_x) % grid_width, (camera_y + view_y) % grid_height);
+          if (cells.Contains(cell)) fill(cell, color);
+        }
+      }
+    } else {
+      for (Cell const &cell : cells) {
+        fill(cell, color);
+      }
+    }
+  };
+  fill_set(frame.obstacles, kObstacle);
+  if (frame.body_cells.Empty()) {
+    for (Cell const &cell : frame.body) {
+      fill(cell, kBody);
+    }
+  } else {
+    fill_set(frame.body_cells, kBody);
+  }
+  fill(frame.head, frame.alive ? kHead : kDeadHead);
+}
+
+/**
+ * @brief Writes an image as a binary PPM file named after its frame number.
+ *
+ * @param number The frame number.
+ * @param pixels The RGB image.
+ *
+ * @return True if the whole file was written.
+ */
+bool FrameExporter::WriteImage(std::size_t number, std::vector<std::uint8_t> const &pixels) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "/frame_%06zu.ppm", number);
+  std::FILE *file = std::fopen((directory + name).c_str(), "wb");
+  if (file == nullptr) return false;
+
+  int const image_width = viewport_width * cell_width;
+  int const image_height = viewport_height * cell_height;
+  bool ok = std::fprintf(file, "P6\n%d %d\n255\n", image_width, image_height) > 0 &&
+            std::fwrite(pixels.data(), 1, pixels.size(), file) == pixels.size();
+  return std::fclose(file) == 0 && ok;
+}
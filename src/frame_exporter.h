@@ -0,0 +1,71 @@
+#ifndef FRAME_EXPORTER_H
+#define FRAME_EXPORTER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "frame_snapshot.h"
+
+/**
+ * @brief Writes snapshots as numbered image files without a window.
+ *
+ * Export() copies a snapshot into one of a fixed set of slots and returns;
+ * a pool of encoder threads rasterises each slot straight from cells to RGB
+ * pixels, with the same colours and camera as Renderer, and writes it as a
+ * binary PPM file (frame_000000.ppm, ...). Slots and pixel buffers are reused,
+ * so the export loop does not allocate once every slot has been used, and
+ * throughput grows with the number of encoder threads.
+ */
+class FrameExporter {
+ public:
+  FrameExporter(const std::string &directory, std::size_t screen_width, std::size_t screen_height,
+                std::size_t grid_width, std::size_t grid_height, std::size_t viewport_width,
+                std::size_t viewport_height, std::size_t thread_count);
+  ~FrameExporter();
+
+  FrameExporter(const FrameExporter &other) = delete;
+  FrameExporter &operator=(const FrameExporter &other) = delete;
+
+  void Export(FrameSnapshot_t const &frame);
+  void Finish(void);
+  std::size_t Written(void) const { return written; }
+  std::size_t Failed(void) const { return failed; }
+
+ private:
+  typedef struct Job {
+    FrameSnapshot_t frame;
+    std::size_t number{0};
+  } Job_t;
+
+  std::string directory;
+  int grid_width;
+  int grid_height;
+  int viewport_width;
+  int viewport_height;
+  int cell_width;
+  int cell_height;
+
+  std::vector<Job_t> jobs;
+  std::deque<std::size_t> free_jobs;
+  std::deque<std::size_t> ready_jobs;
+  std::size_t next_number{0};
+  std::size_t written{0};
+  std::size_t failed{0};
+
+  std::vector<std::thread> encoders;
+  std::mutex mtx;
+  std::condition_variable cv_ready;
+  std::condition_variable cv_free;
+  bool stopping{false};
+
+  void EncoderLoop(void);
+  void Rasterize(FrameSnapshot_t const &frame, std::vector<std::uint8_t> &pixels) const;
+  bool WriteImage(std::size_t number, std::vector<std::uint8_t> const &pixels) const;
+};
+
+#endif /* FRAME_EXPORTER_H */
@@ -0,0 +1,96 @@
+#include "frame_pacer.h"
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+/**
+ * @brief Constructs a pacer for the given period.
+ *
+ * @param period_ms The target period in milliseconds, e.g. 1000.0 / 60 for 60 FPS.
+ * @param vsync True if the caller is already paced by a vsync-locked present.
+ */
+FramePacer::FramePacer(double period_ms, bool vsync)
+    : period_ms(period_ms),
+      vsync(vsync),
+      ticks_per_us(static_cast<double>(SDL_GetPerformanceFrequency()) / 1e6),
+      period_ticks(period_ms * 1000.0 * ticks_per_us) {
+  Start();
+}
+
+/**
+ * @brief Restarts the deadlines from now; the first deadline is one period away.
+ */
+void FramePacer::Start(void) {
+  next_deadline = static_cast<double>(SDL_GetPerformanceCounter()) + period_ticks;
+}
+
+/**
+ * @brief Waits for the next deadline and records how far from it the wake-up was.
+ *
+ * When the loop is late by more than a whole period, the missed deadlines are skipped instead of
+ * being rushed through, and the frame is counted as missed.
+ */
+void FramePacer::Wait(void) {
+  double now = static_cast<double>(SDL_GetPerformanceCounter());
+
+  if (!vsync) {
+    // Sleep for the coarse part, then spin for the precise part.
+    double remaining_us = (next_deadline - now) / ticks_per_us;
+    if (remaining_us > kSpinMarginUs) {
+      std::this_thread::sleep_for(std::chrono::microseconds(
+          static_cast<std::int64_t>(remaining_us - kSpinMarginUs)));
+    }
+    while ((now = static_cast<double>(SDL_GetPerformanceCounter())) < next_deadline) {
+      std::this_thread::yield();
+    }
+  }
+
+  double error_us = std::fabs(now - next_deadline) / ticks_per_us;
+  frames++;
+  error_sum += error_us;
+  error_square_sum += error_us * error_us;
+  if (error_us > error_max) error_max = error_us;
+
+  if (vsync) {
+    // The display sets the phase; only measure each frame against the previous one.
+    next_deadline = now + period_ticks;
+    return;
+  }
+
+  // Judge lateness against the deadline just waited for, before it is advanced.
+  if (now - next_deadline > period_ticks) {
+    missed_frames++;
+    next_deadline = now + period_ticks;
+  } else {
+    next_deadline += period_ticks;
+  }
+}
+
+/**
+ * @brief Returns the wake-up error statistics since the last reset.
+ *
+ * @return The pacing statistics.
+ */
+PacingStats_t FramePacer::GetStats(void) const {
+  PacingStats_t stats;
+  stats.frames = frames;
+  stats.missed_frames = missed_frames;
+  if (frames > 0) {
+    stats.mean_error_us = error_sum / static_cast<double>(frames);
+    double variance = error_square_sum / static_cast<double>(frames) - stats.mean_error_us * stats.mean_error_us;
+    stats.stddev_error_us = std::sqrt(variance > 0.0 ? variance : 0.0);
+    stats.max_error_us = error_max;
+  }
+  return stats;
+}
+
+/**
+ * @brief Clears the wake-up error statistics.
+ */
+void FramePacer::ResetStats(void) {
+  frames = 0;
+  missed_frames = 0;
+  error_sum = 0.0;
+  error_square_sum = 0.0;
+  error_max = 0.0;
+}
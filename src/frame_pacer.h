@@ -0,0 +1,50 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <cstdint>
+#include "SDL.h"
+
+// Wake-up error against the frame deadlines, in microseconds.
+typedef struct PacingStats {
+  std::uint64_t frames{0};
+  double mean_error_us{0.0};
+  double stddev_error_us{0.0};
+  double max_error_us{0.0};
+  std::uint64_t missed_frames{0};
+} PacingStats_t;
+
+/**
+ * @brief Paces a loop to a fractional period using the high-resolution performance counter.
+ *
+ * Deadlines are absolute (start + n * period), so rounding never accumulates
+ * into drift. Wait() sleeps until kSpinMarginUs before the deadline and spins
+ * for the rest. In vsync mode the presented frame already blocks, so Wait()
+ * only records statistics.
+ */
+class FramePacer {
+ public:
+  explicit FramePacer(double period_ms, bool vsync = false);
+
+  void Start(void);
+  void Wait(void);
+  double GetPeriodMs(void) const { return period_ms; }
+  PacingStats_t GetStats(void) const;
+  void ResetStats(void);
+
+ private:
+  static constexpr double kSpinMarginUs{1500.0};
+
+  double period_ms;
+  bool vsync;
+  double ticks_per_us;
+  double period_ticks;
+  double next_deadline{0.0};
+
+  std::uint64_t frames{0};
+  std::uint64_t missed_frames{0};
+  double error_sum{0.0};
+  double error_square_sum{0.0};
+  double error_max{0.0};
+};
+
+#endif /* FRAME_PACER_H */
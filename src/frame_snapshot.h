@@ -0,0 +1,33 @@
+#ifndef FRAME_SNAPSHOT_H
+#define FRAME_SNAPSHOT_H
+
+#include <cstdint>
+#include <vector>
+#include "cell.h"
+#include "cell_hash_set.h"
+#include "item_board.h"
+
+/**
+ * @brief Immutable copy of everything the renderer draws for one simulation tick.
+ */
+typedef struct FrameSnapshot {
+  std::uint64_t tick{0};
+  std::vector<Cell> body;
+  // The body as a set, so the renderer can probe the viewport instead of walking the body; only
+  // filled while the body is longer than kIndexedBodyCells, otherwise empty.
+  static constexpr std::size_t kIndexedBodyCells{4096};
+  CellHashSet body_cells;
+  Cell head;
+  bool alive{true};
+  bool paused{false};
+  // Foods and power-ups, in the board's dense order; only copied again when their version changes.
+  std::vector<Item_t> items;
+  std::uint32_t item_version{0xFFFFFFFFu};
+  CellHashSet obstacles;
+  // Version of the obstacles copied into this snapshot; they are only copied again when it changes.
+  std::uint32_t obstacle_version{0xFFFFFFFFu};
+  int score{0};
+  int size{0};
+} FrameSnapshot_t;
+
+#endif /* FRAME_SNAPSHOT_H */
@@ -1,8 +1,28 @@
 #include "game.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
 #include <iostream>
 #include "SDL.h"
+#include "alloc_counter.h"
+#include "frame_pacer.h"
 #include "manager_db.h"
+#include "metrics.h"
 #include "parser_string.h"
+#include "score_history.h"
+
+namespace {
+constexpr std::size_t kMaxFrameTimes{1024};
+
+// Returns the given percentile of the samples, reordering them.
+double Percentile(std::vector<double> &samples, double percentile) {
+  if (samples.empty()) return 0.0;
+  auto nth = samples.begin() + static_cast<std::ptrdiff_t>(percentile * (samples.size() - 1));
+  std::nth_element(samples.begin(), nth, samples.end());
+  return *nth;
+}
+}  // namespace
 
 /**
  * @brief Constructs a Game object with the specified grid dimensions and level.
@@ -15,16 +35,55 @@
  */
 Game::Game(std::size_t grid_width, std::size_t grid_height, int level)
     : snake(std::make_unique<Snake>(grid_width, grid_height)),
+      planner(static_cast<int>(grid_width), static_cast<int>(grid_height)),
       engine(dev()),
       random_w(0, static_cast<int>(grid_width - 1)),
       random_h(0, static_cast<int>(grid_height - 1)),
-      level(level) {
+      level(level),
+      items(static_cast<int>(grid_width), static_cast<int>(grid_height)) {
   PlaceFood();
   if (level == 2) {
     PlaceObstacles();
-  } else if (level == 3) {
-    StartObstacleThread();
   }
+  ScheduleTimers();
+}
+
+/**
+ * @brief Constructs a Game object on a level from a level pack.
+ *
+ * The board size, walls and spawn point come from the level. Its obstacle waves, if any, are
+ * played on the ticks they are due.
+ *
+ * @param layout The level to play; the pack it belongs to must outlive the game.
+ * @param level The difficulty recorded with the score.
+ */
+Game::Game(PackedLevel const &layout, int level)
+    : snake(std::make_unique<Snake>(layout.Width(), layout.Height())),
+      planner(layout.Width(), layout.Height()),
+      engine(dev()),
+      random_w(0, layout.Width() - 1),
+      random_h(0, layout.Height() - 1),
+      level(level),
+      items(layout.Width(), layout.Height()),
+      layout(layout) {
+  LoadLayout();
+  PlaceFood();
+  ScheduleTimers();
+}
+
+/**
+ * @brief Constructs a Game object from a checkpoint, restoring it exactly.
+ *
+ * @param state The state loaded by CheckpointWriter::Load.
+ */
+Game::Game(GameState_t const &state)
+    : planner(state.scalars.grid_width, state.scalars.grid_height),
+      obstacle_version(state.scalars.obstacle_version),
+      random_w(0, state.scalars.grid_width - 1),
+      random_h(0, state.scalars.grid_height - 1),
+      level(state.scalars.level),
+      items(state.scalars.grid_width, state.scalars.grid_height) {
+  Restore(state);
 }
 
 /**
@@ -38,14 +97,29 @@ Game::Game(std::size_t grid_width, std::size_t grid_height, int level)
  */
 Game::Game(Game&& other) noexcept
     : snake(std::move(other.snake)),
-      food(other.food),
       obstacles(std::move(other.obstacles)),
+      planner(std::move(other.planner)),
+      obstacle_version(other.obstacle_version),
       engine(std::move(other.engine)),
+      engine_version(other.engine_version),
       random_w(std::move(other.random_w)),
       random_h(std::move(other.random_h)),
       score(other.score),
       level(other.level),
-      running(other.running) {}
+      items(std::move(other.items)),
+      item_version(other.item_version),
+      food_count(other.food_count),
+      power_ups(other.power_ups),
+      boost_until(other.boost_until),
+      ghost_until(other.ghost_until),
+      boost_timer(other.boost_timer),
+      steer_target(other.steer_target),
+      checkpoints(std::move(other.checkpoints)),
+      rewind(std::move(other.rewind)),
+      rewind_delta(std::move(other.rewind_delta)),
+      timers(std::move(other.timers)),
+      layout(other.layout),
+      layout_walls(std::move(other.layout_walls)) {}
 
 /**
  * @brief Assigns a Game object by moving its contents.
@@ -59,14 +133,29 @@ Game::Game(Game&& other) noexcept
 Game& Game::operator=(Game&& other) noexcept {
   if (this != &other) {
     snake = std::move(other.snake);
-    food = other.food;
+    items = std::move(other.items);
+    item_version = other.item_version;
+    food_count = other.food_count;
+    power_ups = other.power_ups;
+    boost_until = other.boost_until;
+    ghost_until = other.ghost_until;
+    boost_timer = other.boost_timer;
+    steer_target = other.steer_target;
     obstacles = std::move(other.obstacles);
+    planner = std::move(other.planner);
+    obstacle_version = other.obstacle_version;
     engine = std::move(other.engine);
+    engine_version = other.engine_version;
+    checkpoints = std::move(other.checkpoints);
+    rewind = std::move(other.rewind);
+    rewind_delta = std::move(other.rewind_delta);
     random_w = std::move(other.random_w);
     random_h = std::move(other.random_h);
     score = other.score;
     level = other.level;
-    running = other.running;
+    timers = std::move(other.timers);
+    layout = other.layout;
+    layout_walls = std::move(other.layout_walls);
   }
   return *this;
 }
@@ -74,116 +163,703 @@ Game& Game::operator=(Game&& other) noexcept {
 /**
  * @brief Runs the game loop.
  *
- * This function runs the main game loop, handling input, updating the game state, and rendering the game.
+ * The simulation runs on game_thread at a fixed tick rate and publishes a snapshot after every
+ * tick through a triple buffer. This thread handles input and renders the latest snapshot, so a
+ * slow present does not delay ticks and a slow tick does not drop frames. While the game is paused
+ * or over, both threads block until the player presses a key, so an idle game uses no CPU.
  *
  * @param controller The controller object responsible for handling user input.
  * @param renderer The renderer object responsible for rendering the game.
- * @param target_frame_duration The target duration for each frame in milliseconds.
+ * @param target_frame_duration The target duration for each frame in milliseconds; may be fractional.
  */
-void Game::Run(Controller const &controller, Renderer &renderer,
-               std::size_t target_frame_duration) {
+void Game::Run(Controller &controller, Renderer &renderer,
+               double target_frame_duration) {
   Uint32 title_timestamp = SDL_GetTicks();
-  Uint32 frame_start;
   Uint32 frame_end;
-  Uint32 frame_duration;
   int frame_count = 0;
+  bool window_open = true;
+  FramePacer pacer(target_frame_duration, renderer.HasVsync());
+  std::uint64_t allocation_mark = AllocCounter::Count();
+  // Frame times of the current second, for the published percentiles.
+  std::vector<double> frame_times;
+  frame_times.reserve(kMaxFrameTimes);
+  double const counter_ms = 1000.0 / static_cast<double>(SDL_GetPerformanceFrequency());
+  Uint64 frame_start = SDL_GetPerformanceCounter();
 
-  while (running) {
-    frame_start = SDL_GetTicks();
+  // Publish the initial state before the simulation thread owns the game.
+  PublishFrame();
+  simulating = true;
+  game_thread = std::thread(&Game::Simulate, this, std::ref(controller.Commands()), target_frame_duration);
 
-    // Input, Update, Render - the main game loop.
-    controller.HandleInput(running, *snake);
-    Update();
-    renderer.Render(*snake, food, obstacles);
+  while (window_open) {
+    // Input, Render - the update runs on the simulation thread.
+    controller.HandleInput(window_open);
+    if (controller.Commands().Size() > 0) {
+      Wake();
+    }
 
-    frame_end = SDL_GetTicks();
+    if (WaitingForInput()) {
+      // Draw the frame the simulation stopped on once, then wait for a key instead of drawing it again.
+      frames.Acquire();
+      renderer.UpdateWindowTitle(frames.Front().score, 0, frames.Front().paused ? "Paused" : "Game over");
+      renderer.Render(frames.Front());
+      controller.WaitInput(window_open);
+      Wake();
+      pacer.Start();
+      frame_count = 0;
+      title_timestamp = SDL_GetTicks();
+      frame_start = SDL_GetPerformanceCounter();
+      continue;
+    }
+
+    frames.Acquire();
+    renderer.Render(frames.Front());
 
-    // Keep track of how long each loop through the input/update/render cycle takes.
+    frame_end = SDL_GetTicks();
     frame_count++;
-    frame_duration = frame_end - frame_start;
+    Metrics::Add(Metrics::kFrames);
+    Metrics::Set(Metrics::kScore, frames.Front().score);
+    Metrics::Set(Metrics::kSnakeSize, frames.Front().size);
+    Metrics::Set(Metrics::kInputQueueDepth, static_cast<double>(controller.Commands().Size()));
 
     // After every second, update the window title.
     if (frame_end - title_timestamp >= 1000) {
-      renderer.UpdateWindowTitle(score, frame_count);
+      renderer.UpdateWindowTitle(frames.Front().score, frame_count);
+      Metrics::Set(Metrics::kFps, frame_count);
+      Metrics::Set(Metrics::kFrameTimeP50, Percentile(frame_times, 0.50));
+      Metrics::Set(Metrics::kFrameTimeP90, Percentile(frame_times, 0.90));
+      Metrics::Set(Metrics::kFrameTimeP99, Percentile(frame_times, 0.99));
+      frame_times.clear();
+      if (AllocCounter::Enabled()) {
+        // Covers both the render loop and the simulation thread.
+        std::uint64_t allocations = AllocCounter::Count() - allocation_mark;
+        std::printf("Heap allocations: %llu in %d frames (%.2f per frame)\n",
+                    static_cast<unsigned long long>(allocations), frame_count,
+                    static_cast<double>(allocations) / frame_count);
+        allocation_mark = AllocCounter::Count();
+      }
       frame_count = 0;
       title_timestamp = frame_end;
     }
 
-    // If the time for this frame is too small (i.e. frame_duration is
-    // smaller than the target ms_per_frame), delay the loop to achieve the correct frame rate.
-    if (frame_duration < target_frame_duration) {
-      SDL_Delay(target_frame_duration - frame_duration);
+    // Wait for the next frame deadline.
+    pacer.Wait();
+
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (frame_times.size() < kMaxFrameTimes) {
+      frame_times.push_back((now - frame_start) * counter_ms);
+    }
+    frame_start = now;
+  }
+
+  simulating = false;
+  Wake();
+  if (game_thread.joinable()) {
+    game_thread.join();
+  }
+  if (checkpoints) {
+    // The final state, so that quitting works as a pause.
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      CaptureCheckpoint();
+    }
+    checkpoints->Finish();
+  }
+
+  PacingStats_t stats = pacer.GetStats();
+  std::cout << "Frame pacing: " << stats.frames << " frames, mean error " << stats.mean_error_us
+            << " us, stddev " << stats.stddev_error_us << " us, max " << stats.max_error_us
+            << " us, missed " << stats.missed_frames << std::endl;
+}
+
+/**
+ * @brief Simulation loop run on game_thread.
+ *
+ * @param commands The queue of turns filled by the controller.
+ * @param target_frame_duration The tick period in milliseconds; may be fractional.
+ */
+void Game::Simulate(InputQueue &commands, double target_frame_duration) {
+  FramePacer pacer(target_frame_duration);
+
+  while (simulating) {
+    {
+      // Drivers such as the tick server read the game between ticks.
+      std::unique_lock<std::mutex> lock(mtx);
+      tick_start_ms = tick_end_ms;
+      tick_end_ms = SDL_GetTicks();
+      TakeTurn(commands);
+      if (Idle()) {
+        // Nothing changes until the player presses a key, which the render loop passes on.
+        // sleeping is set before input_arrived is checked, and Wake() sets input_arrived before
+        // it checks sleeping, so one of the two always sees the other and no wake-up is lost.
+        PublishFrame();
+        sleeping = true;
+        wake.wait(lock, [this] { return input_arrived || !simulating; });
+        sleeping = false;
+        input_arrived = false;
+        lock.unlock();
+        pacer.Start();
+        continue;
+      }
+      Update();
+      tick++;
+      RecordRewind();
+      PublishFrame();
+      Metrics::Add(Metrics::kTicks);
+      if (checkpoints && tick % kCheckpointTicks == 0) {
+        CaptureCheckpoint();
+      }
     }
+
+    pacer.Wait();
   }
+}
 
-  if (level == 3) {
-    StopObstacleThread();
+/**
+ * @brief Returns whether the simulation is asleep waiting for input that has not arrived yet.
+ *
+ * Only the render loop wakes the simulation, so when this returns true it stays asleep until the
+ * render loop calls Wake(), and its last published frame is final. Does not lock, so the render
+ * loop can call it every frame without waiting for a tick.
+ */
+bool Game::WaitingForInput(void) {
+  return sleeping && !input_arrived;
+}
+
+/**
+ * @brief Wakes the simulation if it sleeps, so that it reads the queued input.
+ *
+ * mtx is only taken when the simulation is asleep, where it does not hold it; while it ticks this
+ * only sets a flag, so a slow tick never stalls the render loop.
+ */
+void Game::Wake(void) {
+  input_arrived = true;
+  if (sleeping) {
+    // Taking the lock orders the notification after the simulation has started waiting.
+    std::lock_guard<std::mutex> lock(mtx);
+    wake.notify_one();
   }
 }
 
 /**
- * @brief Places food in the game grid.
+ * @brief Copies the current state into the back slot of the triple buffer and publishes it.
+ */
+void Game::PublishFrame(void) {
+  FillFrame(frames.Back());
+  frames.Publish();
+}
+
+/**
+ * @brief Copies the current state into a snapshot.
  *
- * This function populates the game grid with food. The food is placed at a random location that is not occupied by a snake item or obstacle.
+ * Snapshots keep their storage, and obstacles and items are only copied when their version
+ * changed, so a steady-state tick copies the snake's body cells and a few scalars. The body's
+ * hash table, whose size follows its capacity rather than the body, is only copied for bodies
+ * longer than kIndexedBodyCells, where it is proportional to the body as well.
  *
- * @param None
+ * @param frame The snapshot to update.
+ */
+void Game::FillFrame(FrameSnapshot_t &frame) const {
+  frame.tick = tick;
+  CellHashSet const &body = snake->BodyCells();
+  if (frame.body.capacity() < body.Size()) {
+    frame.body.reserve(std::max(2 * body.Size(), body.Cells().capacity()));
+  }
+  frame.body.assign(body.begin(), body.end());
+  if (body.Size() > FrameSnapshot_t::kIndexedBodyCells) {
+    frame.body_cells = body;
+  } else if (!frame.body_cells.Empty()) {
+    frame.body_cells.Clear();
+  }
+  frame.head = snake->HeadCell();
+  frame.alive = snake->alive;
+  frame.paused = paused;
+  if (frame.item_version != item_version) {
+    frame.items = items.Items();
+    frame.item_version = item_version;
+  }
+  if (frame.obstacle_version != obstacle_version) {
+    frame.obstacles = obstacles;
+    frame.obstacle_version = obstacle_version;
+  }
+  frame.score = score;
+  frame.size = snake->size;
+}
+
+/**
+ * @brief Plays the game headless with the autopilot and exports every tick.
  *
- * @return None
+ * Ticks run as fast as the exporter accepts frames, so recording is not tied to real time.
+ * Recording stops early, after exporting the final frame, when the snake dies.
+ *
+ * @param exporter The exporter that encodes the frames.
+ * @param frame_count The maximum number of ticks to record.
+ *
+ * @return The number of frames handed to the exporter.
+ */
+std::size_t Game::Record(FrameExporter &exporter, std::size_t frame_count) {
+  FrameSnapshot_t frame;
+  std::size_t recorded = 0;
+  while (recorded < frame_count) {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (recorded > 0) {
+        AutoSteer();
+        Update();
+        tick++;
+      }
+      FillFrame(frame);
+    }
+    exporter.Export(frame);
+    recorded++;
+    if (!frame.alive) break;
+  }
+  return recorded;
+}
+
+/**
+ * @brief Writes checkpoints of this game to a file while it runs.
+ *
+ * @param path The checkpoint file; it is replaced.
+ */
+void Game::EnableCheckpoints(const std::string &path) {
+  checkpoints = std::make_unique<CheckpointWriter>(path);
+}
+
+/**
+ * @brief Hands the changes since the last capture to the checkpoint writer.
+ *
+ * Must be called with mtx held.
+ */
+void Game::CaptureCheckpoint(void) {
+  CheckpointDelta_t &delta = checkpoints->BeginCapture();
+  if (checkpoint_resync) {
+    // Send the whole body again; cells past the rewound tick belong to another timeline.
+    delta.next_cell = 0;
+    checkpoint_resync = false;
+  }
+  Capture(delta);
+  checkpoints->EndCapture();
+}
+
+/**
+ * @brief Adds the changes since the last capture to a delta.
+ *
+ * Only body cells the delta has not seen are copied, and the obstacles, items and engine only
+ * when their version changed, so the cost does not depend on the snake's length. Must be called
+ * with mtx held.
+ *
+ * @param delta The delta to update; its bookkeeping tracks what it has already seen.
+ */
+void Game::Capture(CheckpointDelta_t &delta) const {
+  CheckpointScalars_t &scalars = delta.scalars;
+  scalars.tick = tick;
+  scalars.level = level;
+  scalars.grid_width = static_cast<std::uint32_t>(snake->GetGridWidth());
+  scalars.grid_height = static_cast<std::uint32_t>(snake->GetGridHeight());
+  scalars.head = snake->head;
+  scalars.progress = snake->progress;
+  scalars.speed = snake->speed;
+  scalars.direction = static_cast<std::uint8_t>(snake->direction);
+  scalars.alive = snake->alive;
+  scalars.growing = snake->Growing();
+  scalars.turned_in_cell = turned_in_cell;
+  scalars.size = snake->size;
+  scalars.score = score;
+  scalars.cells_added = snake->cells_added;
+  scalars.obstacle_version = obstacle_version;
+  scalars.item_version = item_version;
+  scalars.boost_until = boost_until;
+  scalars.ghost_until = ghost_until;
+
+  std::uint64_t const body_first = snake->cells_added - snake->body.size();
+  std::uint64_t const first_new = std::max(delta.next_cell, body_first);
+  if (delta.new_cells.empty() || first_new != delta.first_cell + delta.new_cells.size()) {
+    delta.new_cells.clear();
+    delta.first_cell = first_new;
+  }
+  for (std::uint64_t i = first_new; i < snake->cells_added; ++i) {
+    delta.new_cells.push_back(snake->body[i - body_first]);
+  }
+  delta.next_cell = snake->cells_added;
+
+  if (delta.seen_obstacle_version != obstacle_version) {
+    delta.obstacles.assign(obstacles.begin(), obstacles.end());
+    delta.obstacles_changed = true;
+    delta.seen_obstacle_version = obstacle_version;
+  }
+  if (delta.seen_item_version != item_version) {
+    delta.items.assign(items.Items().begin(), items.Items().end());
+    delta.items_changed = true;
+    delta.seen_item_version = item_version;
+  }
+  if (delta.seen_engine_version != engine_version) {
+    delta.engine = engine;
+    delta.engine_changed = true;
+    delta.seen_engine_version = engine_version;
+  }
+}
+
+/**
+ * @brief Keeps a history of the last ticks so that the game can be rewound.
+ *
+ * @param memory The memory the history may use, in bytes; it bounds how far back the game can
+ *               be rewound.
+ */
+void Game::EnableRewind(std::size_t memory) {
+  std::lock_guard<std::mutex> lock(mtx);
+  rewind = std::make_unique<RewindBuffer>(memory);
+  rewind_delta = CheckpointDelta_t{};
+  RecordRewind();
+}
+
+/**
+ * @brief Sets how many foods the board holds and whether power-ups appear.
+ *
+ * @param food_count The number of foods kept on the board; at least one.
+ * @param power_ups Whether a speed, shrink or ghost power-up appears every kPowerUpTicks ticks.
+ */
+void Game::EnableItems(std::size_t food_count, bool power_ups) {
+  std::lock_guard<std::mutex> lock(mtx);
+  this->food_count = std::max<std::size_t>(food_count, 1);
+  this->power_ups = power_ups;
+  PlaceFood();
+  ScheduleTimers();
+}
+
+/**
+ * @brief Steps the game back.
+ *
+ * @param ticks The number of ticks to step back.
+ *
+ * @return The number of ticks stepped back; fewer when the history does not reach that far.
+ */
+std::uint64_t Game::Rewind(std::uint64_t ticks) {
+  std::lock_guard<std::mutex> lock(mtx);
+  std::uint64_t const rewound = StepBack(ticks);
+  if (rewound > 0) {
+    PublishFrame();
+  }
+  return rewound;
+}
+
+/**
+ * @brief Adds the current tick to the rewind history. Must be called with mtx held.
+ */
+void Game::RecordRewind(void) {
+  if (!rewind) return;
+  Capture(rewind_delta);
+  rewind->Record(rewind_delta);
+}
+
+/**
+ * @brief Restores the state of an earlier tick from the rewind history. Must be called with mtx held.
+ *
+ * @param ticks The number of ticks to step back.
+ *
+ * @return The number of ticks stepped back.
+ */
+std::uint64_t Game::StepBack(std::uint64_t ticks) {
+  if (!rewind || rewind->Empty()) return 0;
+  std::uint64_t const target = std::max(rewind->OldestTick(), tick > ticks ? tick - ticks : 0);
+  GameState_t state;
+  if (target >= tick || !rewind->Seek(target, state)) return 0;
+
+  std::uint64_t const rewound = tick - target;
+  Restore(state);
+  // The history now ends at the restored tick, so only later changes are captured.
+  rewind_delta.next_cell = snake->cells_added;
+  rewind_delta.seen_obstacle_version = obstacle_version;
+  rewind_delta.seen_item_version = item_version;
+  rewind_delta.seen_engine_version = engine_version;
+  checkpoint_resync = true;
+  return rewound;
+}
+
+/**
+ * @brief Replaces the state of the game with a saved one.
+ *
+ * The obstacle, item and engine versions move forward rather than back, so snapshots and captures
+ * see the restored obstacles and engine as changes. Must be called with mtx held.
+ *
+ * @param state The state, from a checkpoint or the rewind history.
+ */
+void Game::Restore(GameState_t const &state) {
+  snake = std::make_unique<Snake>(state.scalars.grid_width, state.scalars.grid_height);
+  snake->head = state.scalars.head;
+  snake->progress = state.scalars.progress;
+  snake->speed = state.scalars.speed;
+  snake->direction = static_cast<Snake::Direction>(state.scalars.direction);
+  snake->size = state.scalars.size;
+  snake->alive = state.scalars.alive != 0;
+  snake->RestoreBody(state.body, state.scalars.cells_added);
+  if (state.scalars.growing) {
+    snake->GrowBody();
+  }
+  score = state.scalars.score;
+  turned_in_cell = state.scalars.turned_in_cell != 0;
+  pending_count = 0;
+  tick = state.scalars.tick;
+  obstacles.Assign(state.obstacles.begin(), state.obstacles.end());
+  obstacle_version++;
+  items.Assign(state.items);
+  item_version++;
+  boost_until = state.scalars.boost_until;
+  ghost_until = state.scalars.ghost_until;
+  engine = state.engine;
+  engine_version++;
+  ScheduleTimers();
+}
+
+/**
+ * @brief Places foods until the board holds food_count of them.
+ *
+ * Stops early when no free cell is found, as on a crowded board; the next food eaten tries again.
  */
 void Game::PlaceFood(void) {
-  int x, y;
-  while (true) {
-    x = random_w(engine);
-    y = random_h(engine);
-    // Check that the location is not occupied by a snake item or obstacle before placing food.
-    bool valid = true;
-    for (const auto& obstacle : obstacles) {
-      if (obstacle.x == x && obstacle.y == y) {
-        valid = false;
-        break;
+  while (items.Count(ItemKind::kFood) < food_count) {
+    if (!PlaceItem(ItemKind::kFood, 0)) break;
+  }
+}
+
+/**
+ * @brief Places an item on a random cell that is not occupied by the snake, an obstacle or
+ * another item.
+ *
+ * @param kind The kind of item.
+ * @param expires The tick on which the item disappears, or 0 if it stays until eaten.
+ *
+ * @return False if no free cell was found in a bounded number of draws.
+ */
+bool Game::PlaceItem(ItemKind kind, std::uint64_t expires) {
+  constexpr int kAttempts{64};
+  engine_version++;
+  for (int attempt = 0; attempt < kAttempts; ++attempt) {
+    Cell cell(random_w(engine), random_h(engine));
+    if (obstacles.Contains(cell) || items.Contains(cell) || snake->SnakeCell(cell)) continue;
+    items.Add(Item_t{cell, kind, expires});
+    item_version++;
+    if (expires > 0) {
+      timers.Schedule(expires, kExpireItem, cell.Id());
+    }
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Applies the effect of an item the snake has just eaten.
+ *
+ * @param item The item, already removed from the board.
+ */
+void Game::Eat(Item_t const &item) {
+  switch (item.kind) {
+    case ItemKind::kFood:
+      score++;
+      PlaceFood();
+      // Grow snake and increase speed.
+      snake->GrowBody();
+      snake->speed += 0.02;
+      break;
+    case ItemKind::kSpeed:
+      // Another speed power-up while boosted only makes the boost last longer.
+      if (tick >= boost_until) {
+        snake->speed += kBoostSpeed;
       }
+      timers.Cancel(boost_timer);
+      boost_until = tick + kEffectTicks;
+      boost_timer = timers.Schedule(boost_until, kEndBoost);
+      break;
+    case ItemKind::kShrink:
+      snake->Shrink(kShrinkCells);
+      break;
+    case ItemKind::kGhost:
+      ghost_until = tick + kEffectTicks;
+      break;
+  }
+}
+
+/**
+ * @brief Reads the queued commands: rewinds and pauses apply now, turns wait for their cell step.
+ *
+ * While the game is paused or over turns are dropped, so that a pause or rewind always gets
+ * through. When more turns are pending than fit, the newest ones are dropped.
+ *
+ * @param commands The queue filled by the controller.
+ */
+void Game::TakeTurn(InputQueue &commands) {
+  InputCommand_t command;
+  while (commands.Pop(command)) {
+    if (command.rewind) {
+      StepBack(kRewindTicks);
+      continue;
     }
-    if (valid && !snake->SnakeCell(x, y)) {
-      food.x = x;
-      food.y = y;
-      return;
+    if (command.pause) {
+      paused = !paused;
+      continue;
     }
+    if (Idle() || pending_count == kMaxPendingTurns) continue;
+    pending_turns[pending_count++] = command;
   }
 }
 
 /**
- * @brief Updates the game state.
+ * @brief Applies the first pending turn pressed by the time of a cell step.
  *
- * This function updates the game state by moving the snake, checking for collisions with food and obstacles, and updating the score.
+ * Turns that would not change the direction (same direction or a reversal) are dropped, so a
+ * quick "up then left" is applied as two turns on two consecutive cells instead of the second
+ * press overwriting the first. Turns pressed after the step wait for a later one.
  *
- * @param None
+ * @param step_ms The SDL time the step stands for.
+ */
+void Game::ApplyPendingTurn(Uint32 step_ms) {
+  std::size_t used = 0;
+  while (used < pending_count && static_cast<Sint32>(pending_turns[used].timestamp - step_ms) <= 0) {
+    Snake::Direction const before = snake->direction;
+    Steer(pending_turns[used++].direction);
+    if (snake->direction != before) break;
+  }
+  std::copy(pending_turns.begin() + used, pending_turns.begin() + pending_count, pending_turns.begin());
+  pending_count -= used;
+}
+
+/**
+ * @brief Steers the snake toward a food, avoiding cells that would kill it.
  *
- * @return None
+ * A greedy choice among the directions that do not reverse: the safe neighbour closest to the
+ * target food on the wrapped board wins. Like queued turns, at most one turn is taken per cell.
+ * The target is the nearest food, picked again only once it is gone, so the items are not
+ * scanned on every tick.
+ */
+void Game::AutoSteer(void) {
+  if (turned_in_cell) return;
+
+  int const grid_w = snake->GetGridWidth();
+  int const grid_h = snake->GetGridHeight();
+  auto wrapped = [](int from, int to, int size) {
+    int distance = std::abs(from - to);
+    return std::min(distance, size - distance);
+  };
+
+  auto step = [](Snake::Direction direction, int &dx, int &dy) {
+    dx = (direction == Snake::Direction::kRight) - (direction == Snake::Direction::kLeft);
+    dy = (direction == Snake::Direction::kDown) - (direction == Snake::Direction::kUp);
+  };
+
+  Cell const head = snake->HeadCell();
+  const Item_t *target = items.Find(steer_target);
+  if (target == nullptr || target->kind != ItemKind::kFood) {
+    int target_distance = -1;
+    for (Item_t const &item : items.Items()) {
+      if (item.kind != ItemKind::kFood) continue;
+      int distance = wrapped(head.x, item.cell.x, grid_w) + wrapped(head.y, item.cell.y, grid_h);
+      if (target_distance < 0 || distance < target_distance) {
+        steer_target = item.cell;
+        target_distance = distance;
+      }
+    }
+  }
+
+  Snake::Direction const before = snake->direction;
+  int before_dx, before_dy;
+  step(before, before_dx, before_dy);
+
+  Snake::Direction best = before;
+  int best_distance = -1;
+  for (Snake::Direction direction : {Snake::Direction::kUp, Snake::Direction::kDown, Snake::Direction::kLeft,
+                                     Snake::Direction::kRight}) {
+    int dx, dy;
+    step(direction, dx, dy);
+    // Same rule as Steer: only a snake without a body may reverse.
+    if (dx == -before_dx && dy == -before_dy && snake->size > 1) continue;
+    Cell next((head.x + dx + grid_w) % grid_w, (head.y + dy + grid_h) % grid_h);
+    if (obstacles.Contains(next) || snake->SnakeCell(next)) continue;
+
+    int distance = wrapped(next.x, steer_target.x, grid_w) + wrapped(next.y, steer_target.y, grid_h);
+    if (best_distance < 0 || distance < best_distance) {
+      best = direction;
+      best_distance = distance;
+    }
+  }
+
+  snake->direction = best;
+  if (best != before) {
+    turned_in_cell = true;
+  }
+}
+
+/**
+ * @brief Updates the game state.
+ *
+ * The timed events due on this tick fire first. The snake then moves one cell at a time, taking
+ * the pending turn pressed by each step's time, and items and obstacles are checked in every cell
+ * it enters, so nothing is skipped when it moves several cells in one tick. Finding the item on a
+ * cell is O(1), however many are on the board.
  */
 void Game::Update(void) {
+  timers.Advance(tick, [this](std::uint32_t event, std::uint32_t data) { FireTimer(event, data); });
   if (!snake->alive) return;
 
-  snake->Update();
+  int const steps = snake->Advance();
+  for (int step = 1; step <= steps && snake->alive; ++step) {
+    ApplyPendingTurn(tick_start_ms + (tick_end_ms - tick_start_ms) * step / steps);
+    snake->StepCell();
+    turned_in_cell = false;
+    Cell new_head = snake->HeadCell();
 
-  int new_x = static_cast<int>(snake->head_x);
-  int new_y = static_cast<int>(snake->head_y);
+    // Check if there's food or a power-up over here
+    Item_t item;
+    if (items.Remove(new_head, item)) {
+      item_version++;
+      Eat(item);
+    }
 
-  // Check if there's food over here
-  if (food.x == new_x && food.y == new_y) {
-    score++;
-    PlaceFood();
-    // Grow snake and increase speed.
-    snake->GrowBody();
-    snake->speed += 0.02;
+    // Check if the snake has collided with an obstacle; a ghost passes through them.
+    if (obstacles.Contains(new_head) && tick >= ghost_until) {
+      snake->alive = false;
+    }
   }
+}
 
-  // Check if the snake has collided with an obstacle
-  for (const auto& obstacle : obstacles) {
-    if (obstacle.x == new_x && obstacle.y == new_y) {
-      snake->alive = false;
+/**
+ * @brief Advances the game by one tick without rendering.
+ *
+ * This is used by drivers other than Run, such as the tick server, which own the loop themselves.
+ *
+ * @param publish Whether to also publish a frame snapshot, as the simulation thread does each tick.
+ */
+void Game::Step(bool publish) {
+  std::lock_guard<std::mutex> lock(mtx);
+  Update();
+  tick++;
+  RecordRewind();
+  if (publish) {
+    PublishFrame();
+  }
+}
+
+/**
+ * @brief Changes the snake's direction, unless it would reverse onto its own body.
+ *
+ * @param input The requested direction.
+ */
+void Game::Steer(Snake::Direction input) {
+  Snake::Direction opposite;
+  switch (input) {
+    case Snake::Direction::kUp:
+      opposite = Snake::Direction::kDown;
+      break;
+    case Snake::Direction::kDown:
+      opposite = Snake::Direction::kUp;
+      break;
+    case Snake::Direction::kLeft:
+      opposite = Snake::Direction::kRight;
+      break;
+    default:
+      opposite = Snake::Direction::kLeft;
       break;
-    }
   }
+  if (snake->direction != opposite || snake->size == 1) snake->direction = input;
 }
 
 /**
@@ -204,22 +880,38 @@ int Game::GetScore(void) const { return score; }
  */
 int Game::GetSize(void) const { return snake->size; }
 
+/**
+ * @brief Returns the cell of one food, for clients that show a single food.
+ *
+ * @return The first food in the item storage, or the head's cell when there is none.
+ */
+Cell Game::GetFood(void) const {
+  for (Item_t const &item : items.Items()) {
+    if (item.kind == ItemKind::kFood) return item.cell;
+  }
+  return snake->HeadCell();
+}
+
 /**
  * @brief Saves the game state to the database.
  *
  * This function saves the game state, including the player's score and size, to the database.
+ * The player's level entry keeps rolling aggregates and only the most recent raw entries.
  *
  * @param db_path The path to the database file.
  * @param info The player's information, including their name, level, score, and size.
+ * @param retention The number of recent games kept as raw entries per player and level.
  */
-void Game::SaveGame(const std::string &db_path, const PlayerInfo_t &info) {
+void Game::SaveGame(const std::string &db_path, const PlayerInfo_t &info, std::size_t retention) {
   std::lock_guard<std::mutex> lock(mtx);
+  auto start = std::chrono::steady_clock::now();
   ManagerDBJson db(db_path);
   json info_data = db.ReadJsonFile(info.name);
-  info_data[Parser::LevelToString(info.level)]["Score"].push_back(info.score);
-  info_data[Parser::LevelToString(info.level)]["Size"].push_back(info.size);
+  ScoreHistory::Record(info_data[Parser::LevelToString(info.level)], info.score, info.size, retention);
   db.UpdateJsonFile(info.name, info_data);
   db.SaveJsonFile();
+  Metrics::Set(Metrics::kDbSaveLatency,
+               std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
 }
 
 /**
@@ -232,70 +924,190 @@ void Game::SaveGame(const std::string &db_path, const PlayerInfo_t &info) {
  * @return None
  */
 void Game::PlaceObstacles(void) {
+  obstacles.Reserve(2 * (snake->GetGridWidth() + snake->GetGridHeight()));
   for (int i = 0; i < static_cast<int>(snake->GetGridWidth()); ++i) {
-    obstacles.push_back(SDL_Point{i, 0});
-    obstacles.push_back(SDL_Point{i, static_cast<int>(snake->GetGridHeight()) - 1});
+    obstacles.Insert(Cell(i, 0));
+    obstacles.Insert(Cell(i, snake->GetGridHeight() - 1));
   }
   for (int i = 0; i < static_cast<int>(snake->GetGridHeight()); ++i) {
-    obstacles.push_back(SDL_Point{0, i});
-    obstacles.push_back(SDL_Point{static_cast<int>(snake->GetGridWidth()) - 1, i});
+    obstacles.Insert(Cell(0, i));
+    obstacles.Insert(Cell(snake->GetGridWidth() - 1, i));
   }
+  obstacle_version++;
 }
 
 /**
- * @brief Starts a separate thread to change the obstacles in the game.
- * 
- * @param None
+ * @brief Replaces the obstacles with a new random set.
  *
- * @return None
+ * Fired every kObstacleChangeTicks ticks on level 3. Must be called with mtx held.
  */
 void Game::ChangeObstacles(void) {
-  std::unique_lock<std::mutex> lock(mtx);
-  while (running) {
-    cv.wait_for(lock, std::chrono::seconds(5), [this] { return !running; });
-    if (!running) break;
-
-    // Clear existing obstacles
-    obstacles.clear();
-
-    // Add new random obstacles
-    int num_obstacles = random_w(engine) % 10 + 5;  // Random number of obstacles between 5 and 15
-    for (int i = 0; i < num_obstacles; ++i) {
-      SDL_Point obstacle;
-      do {
-        obstacle.x = random_w(engine);
-        obstacle.y = random_h(engine);
-      } while (snake->SnakeCell(obstacle.x, obstacle.y) || (food.x == obstacle.x && food.y == obstacle.y));
-      obstacles.push_back(obstacle);
+  // Pick the new random obstacles, then swap them in as one bulk replace. Candidates that would
+  // cut off part of the board are skipped; the number of draws is bounded, so a small or
+  // crowded board may get fewer obstacles.
+  engine_version++;
+  int num_obstacles = random_w(engine) % kRandomObstacleSpread + kMinRandomObstacles;
+  int attempts = 4 * num_obstacles;
+  // Sized once for the largest set, so later changes reuse the storage.
+  std::size_t const max_obstacles = kMinRandomObstacles + kRandomObstacleSpread;
+  obstacle_candidates.reserve(max_obstacles);
+  obstacles.Reserve(max_obstacles);
+  planner.Reserve(max_obstacles);
+  obstacle_candidates.clear();
+  planner.Reset();
+  while (static_cast<int>(obstacle_candidates.size()) < num_obstacles && attempts-- > 0) {
+    Cell obstacle(random_w(engine), random_h(engine));
+    if (snake->SnakeCell(obstacle) || items.Contains(obstacle) || planner.Blocked(obstacle)) continue;
+    if (planner.TryBlock(obstacle)) {
+      obstacle_candidates.push_back(obstacle);
     }
   }
+  obstacles.Assign(obstacle_candidates.begin(), obstacle_candidates.end());
+  obstacle_version++;
+  Metrics::Add(Metrics::kObstacleChanges);
 }
 
 /**
- * @brief Starts a separate thread to change the obstacles in the game.
- * 
- * @param None
+ * @brief Places the walls of the pack level and moves the snake to its first spawn point.
+ */
+void Game::LoadLayout(void) {
+  layout_walls.reserve(layout->WallCount());
+  layout->AppendWalls(layout_walls);
+  obstacles.Assign(layout_walls.begin(), layout_walls.end());
+  obstacle_version++;
+  if (layout->SpawnCount() > 0) {
+    snake->head = layout->Spawn(0);
+  }
+}
+
+/**
+ * @brief Replaces the current wave with a new one, keeping the level's walls.
  *
- * @return None
+ * Wave cells under the snake or an item are skipped.
+ *
+ * @param wave The wave to apply.
  */
-void Game::StartObstacleThread(void) {
-  obstacle_thread = std::thread(&Game::ChangeObstacles, this);
+void Game::ApplyWave(LevelWave_t const &wave) {
+  obstacle_candidates.assign(layout_walls.begin(), layout_walls.end());
+  for (std::size_t i = 0; i < wave.cell_count; ++i) {
+    Cell cell = wave.cells[i];
+    if (!items.Contains(cell) && !snake->SnakeCell(cell)) {
+      obstacle_candidates.push_back(cell);
+    }
+  }
+  obstacles.Assign(obstacle_candidates.begin(), obstacle_candidates.end());
+  obstacle_version++;
+  Metrics::Add(Metrics::kObstacleChanges);
 }
 
 /**
- * @brief Stops the obstacle thread and cleans up resources.
- * 
- * @param None
+ * @brief Schedules the timed events from the current tick on.
  *
- * @return None
+ * Called when the game starts, when it is restored and when its items are enabled; the events
+ * of a restored game are due on the same ticks as they were when it was saved.
  */
-void Game::StopObstacleThread(void) {
-  {
-    std::lock_guard<std::mutex> lock(mtx);
-    running = false;
+void Game::ScheduleTimers(void) {
+  timers.Reset(tick);
+  if (level == 3 && !layout) {
+    // The first change comes kObstacleChangeTicks ticks into the game, then one every period.
+    std::uint64_t const periods = (tick + kObstacleChangeTicks - 1) / kObstacleChangeTicks;
+    timers.Schedule(std::max<std::uint64_t>(periods, 1) * kObstacleChangeTicks, kChangeObstacles);
+  }
+  if (layout && layout->WaveCount() > 0) {
+    ScheduleWave(tick);
+  }
+  if (power_ups) {
+    std::uint64_t const periods = (tick + kPowerUpTicks - 1) / kPowerUpTicks;
+    timers.Schedule(std::max<std::uint64_t>(periods, 1) * kPowerUpTicks, kSpawnPowerUp);
+  }
+  for (Item_t const &item : items.Items()) {
+    if (item.expires > 0) {
+      timers.Schedule(item.expires, kExpireItem, item.cell.Id());
+    }
   }
-  cv.notify_all();
-  if (obstacle_thread.joinable()) {
-    obstacle_thread.join();
+  boost_timer = TimerWheel::kNoTimer;
+  if (boost_until > tick) {
+    boost_timer = timers.Schedule(boost_until, kEndBoost);
   }
 }
+
+/**
+ * @brief Schedules the first wave of the pack level due at or after a tick.
+ *
+ * Each wave is due at its time since the start of the level and replaces the previous one. If
+ * the level repeats, the schedule starts over every RepeatMs() milliseconds.
+ *
+ * @param from The earliest tick for the wave.
+ */
+void Game::ScheduleWave(std::uint64_t from) {
+  auto ticks = [](std::uint64_t ms) { return (ms * kTicksPerSecond + 500) / 1000; };
+  std::uint64_t const repeat = ticks(layout->RepeatMs());
+  std::uint64_t start = 0;
+  if (repeat > 0) {
+    start = from / repeat * repeat;
+  }
+  for (int cycle = 0; cycle < 2; ++cycle) {
+    for (std::size_t i = 0; i < layout->WaveCount(); ++i) {
+      std::uint64_t const due = start + ticks(layout->Wave(i).at_ms);
+      if (due >= from && (repeat == 0 || due < start + repeat)) {
+        // Of several waves due on the same tick, the last one replaces the others.
+        while (i + 1 < layout->WaveCount() && start + ticks(layout->Wave(i + 1).at_ms) == due) {
+          i++;
+        }
+        timers.Schedule(due, kPlayWave, static_cast<std::uint32_t>(i));
+        return;
+      }
+    }
+    if (repeat == 0) return;
+    start += repeat;
+  }
+}
+
+/**
+ * @brief Handles a timed event and schedules its next occurrence. Must be called with mtx held.
+ *
+ * @param event The TimedEvent.
+ * @param data The wave index for kPlayWave, the item's cell id for kExpireItem.
+ */
+void Game::FireTimer(std::uint32_t event, std::uint32_t data) {
+  switch (event) {
+    case kChangeObstacles:
+      ChangeObstacles();
+      timers.Schedule(tick + kObstacleChangeTicks, kChangeObstacles);
+      break;
+    case kPlayWave:
+      ApplyWave(layout->Wave(data));
+      ScheduleWave(tick + 1);
+      break;
+    case kSpawnPowerUp:
+      SpawnPowerUp();
+      timers.Schedule(tick + kPowerUpTicks, kSpawnPowerUp);
+      break;
+    case kExpireItem: {
+      // The timer of an item eaten earlier may find another item on its cell.
+      Cell const cell = Cell::FromId(data);
+      const Item_t *item = items.Find(cell);
+      Item_t removed;
+      if (item != nullptr && item->expires == tick && items.Remove(cell, removed)) {
+        item_version++;
+      }
+      break;
+    }
+    case kEndBoost:
+      snake->speed -= kBoostSpeed;
+      boost_timer = TimerWheel::kNoTimer;
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+ * @brief Places a random power-up that disappears after kPowerUpLifetimeTicks ticks.
+ */
+void Game::SpawnPowerUp(void) {
+  constexpr ItemKind kPowerUps[]{ItemKind::kSpeed, ItemKind::kShrink, ItemKind::kGhost};
+  engine_version++;
+  ItemKind const kind = kPowerUps[random_w(engine) % 3];
+  PlaceItem(kind, tick + kPowerUpLifetimeTicks);
+}
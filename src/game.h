@@ -1,16 +1,31 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <array>
+#include <cstdint>
+#include <atomic>
 #include <random>
 #include <string>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
 #include "SDL.h"
+#include "cell.h"
+#include "cell_hash_set.h"
+#include "checkpoint.h"
 #include "controller.h"
+#include "frame_exporter.h"
+#include "frame_snapshot.h"
+#include "item_board.h"
+#include "level_pack.h"
+#include "obstacle_planner.h"
 #include "renderer.h"
+#include "rewind_buffer.h"
 #include "snake.h"
+#include "timer_wheel.h"
+#include "triple_buffer.h"
 
 typedef struct PlayerInfo {
   std::string name;
@@ -22,6 +37,8 @@ typedef struct PlayerInfo {
 class Game {
  public:
   Game(std::size_t grid_width, std::size_t grid_height, int level);
+  Game(PackedLevel const &layout, int level);
+  explicit Game(GameState_t const &state);
 
   // Move constructor
   Game(Game&& other) noexcept;
@@ -33,41 +50,148 @@ class Game {
   Game(const Game& other) = delete;
   Game& operator=(const Game& other) = delete;
 
-  void Run(Controller const &controller, Renderer &renderer,
-           std::size_t target_frame_duration);
+  void Run(Controller &controller, Renderer &renderer,
+           double target_frame_duration);
+  void Step(bool publish = false);
+  std::size_t Record(FrameExporter &exporter, std::size_t frame_count);
+  void EnableCheckpoints(const std::string &path);
+  void EnableRewind(std::size_t memory);
+  void EnableItems(std::size_t food_count, bool power_ups);
+  std::uint64_t Rewind(std::uint64_t ticks);
+  void Steer(Snake::Direction input);
   int GetScore(void) const;
   int GetSize(void) const;
+  Snake const &GetSnake(void) const { return *snake; }
+  Cell GetFood(void) const;
+  ItemBoard const &GetItems(void) const { return items; }
+  CellHashSet const &GetObstacles(void) const { return obstacles; }
+  std::uint32_t GetObstacleVersion(void) const { return obstacle_version; }
+  std::mutex &GetMutex(void) { return mtx; }
 
-  void SaveGame(const std::string &db_path, const PlayerInfo_t &info);
+  void SaveGame(const std::string &db_path, const PlayerInfo_t &info, std::size_t retention);
 
  private:
+  // Ticks per second of the simulation, which timed events are counted in.
+  static constexpr std::uint64_t kTicksPerSecond{60};
+
   std::unique_ptr<Snake> snake;
-  SDL_Point food;
-  std::vector<SDL_Point> obstacles;
+  CellHashSet obstacles;
+  std::vector<Cell> obstacle_candidates;
+  // Keeps random obstacles from cutting the board into separate regions.
+  ObstaclePlanner planner;
+  // Incremented whenever the obstacle set changes.
+  std::uint32_t obstacle_version{0};
 
   std::random_device dev;
   std::mt19937 engine;
+  // Incremented whenever the engine is used, so checkpoints only copy it when it changed.
+  std::uint32_t engine_version{0};
   std::uniform_int_distribution<int> random_w;
   std::uniform_int_distribution<int> random_h;
 
   int score{0};
   int level;
 
+  // Foods and power-ups. The board keeps food_count foods; with power-ups on, one appears every
+  // kPowerUpTicks ticks and disappears after kPowerUpLifetimeTicks unless eaten.
+  static constexpr std::uint64_t kPowerUpTicks{10 * kTicksPerSecond};
+  static constexpr std::uint64_t kPowerUpLifetimeTicks{6 * kTicksPerSecond};
+  static constexpr std::uint64_t kEffectTicks{5 * kTicksPerSecond};
+  static constexpr float kBoostSpeed{0.1f};
+  static constexpr int kShrinkCells{3};
+  ItemBoard items;
+  // Incremented whenever the items change.
+  std::uint32_t item_version{0};
+  std::size_t food_count{1};
+  bool power_ups{false};
+  // Ticks on which the speed and ghost power-ups wear off.
+  std::uint64_t boost_until{0};
+  std::uint64_t ghost_until{0};
+  TimerWheel::TimerId boost_timer{TimerWheel::kNoTimer};
+  // Food the autopilot steers toward; another is picked when it is gone.
+  Cell steer_target;
+
+  // Set once the autopilot turned in the current cell; cleared when the head enters a new cell.
+  bool turned_in_cell{false};
+
+  // Turns read from the input queue but not applied yet. Each applies on the first cell step at
+  // or after its key press, at most one per step, so presses within one tick turn on consecutive
+  // cells. The steps of a tick are spread evenly from the previous tick's SDL time to its own.
+  static constexpr std::size_t kMaxPendingTurns{16};
+  std::array<InputCommand_t, kMaxPendingTurns> pending_turns{};
+  std::size_t pending_count{0};
+  Uint32 tick_start_ms{0};
+  Uint32 tick_end_ms{0};
+  void ApplyPendingTurn(Uint32 step_ms);
+
   void PlaceFood(void);
+  bool PlaceItem(ItemKind kind, std::uint64_t expires);
+  void Eat(Item_t const &item);
+  void TakeTurn(InputQueue &commands);
+  void AutoSteer(void);
   void Update(void);
 
-  // Threading and synchronization
+  // Simulation thread and the snapshots it publishes to the render loop.
   std::thread game_thread;
-  std::thread input_thread;
-  std::thread obstacle_thread;
+  std::atomic<bool> simulating{false};
+  std::uint64_t tick{0};
+  TripleBuffer<FrameSnapshot_t> frames;
+
+  void Simulate(InputQueue &commands, double target_frame_duration);
+
+  // While paused or over, the simulation sleeps on wake instead of ticking, and the render loop
+  // blocks on input instead of drawing; it wakes the simulation when input arrives. The flags are
+  // atomic so that the render loop only takes mtx to notify a simulation that is asleep.
+  bool paused{false};
+  std::atomic<bool> sleeping{false};
+  std::atomic<bool> input_arrived{false};
+  std::condition_variable wake;
+  bool Idle(void) const { return paused || !snake->alive; }
+  bool WaitingForInput(void);
+  void Wake(void);
+
+  // Checkpoints are captured every kCheckpointTicks ticks and written by a background thread.
+  static constexpr std::uint64_t kCheckpointTicks{30};
+  std::unique_ptr<CheckpointWriter> checkpoints;
+  // Set by a rewind, whose body cells the writer may have seen on the abandoned timeline.
+  bool checkpoint_resync{false};
+  void CaptureCheckpoint(void);
+  void Capture(CheckpointDelta_t &delta) const;
+  void Restore(GameState_t const &state);
+
+  // History of recent ticks; the rewind key steps back kRewindTicks ticks.
+  static constexpr std::uint64_t kRewindTicks{kTicksPerSecond};
+  std::unique_ptr<RewindBuffer> rewind;
+  CheckpointDelta_t rewind_delta;
+  void RecordRewind(void);
+  std::uint64_t StepBack(std::uint64_t ticks);
+  void PublishFrame(void);
+  void FillFrame(FrameSnapshot_t &frame) const;
+
+  // Threading and synchronization
   std::mutex mtx;
-  std::condition_variable cv;
-  bool running{true};
+
+  // Timed events, fired by Update() on the tick they are due. Their schedule depends only on
+  // the tick, so it is rebuilt rather than saved when a checkpoint or rewind restores the game.
+  enum TimedEvent : std::uint32_t { kChangeObstacles, kPlayWave, kSpawnPowerUp, kExpireItem, kEndBoost };
+  static constexpr std::uint64_t kObstacleChangeTicks{5 * kTicksPerSecond};
+  // Each change places kMinRandomObstacles to kMinRandomObstacles + kRandomObstacleSpread - 1 obstacles.
+  static constexpr int kMinRandomObstacles{5};
+  static constexpr int kRandomObstacleSpread{10};
+  TimerWheel timers;
+  void ScheduleTimers(void);
+  void ScheduleWave(std::uint64_t from);
+  void FireTimer(std::uint32_t event, std::uint32_t data);
+  void SpawnPowerUp(void);
+
+  // Level from a level pack, if any; its walls stay in place while its waves come and go.
+  std::optional<PackedLevel> layout;
+  std::vector<Cell> layout_walls;
 
   void PlaceObstacles(void);
   void ChangeObstacles(void);
-  void StartObstacleThread(void);
-  void StopObstacleThread(void);
+  void LoadLayout(void);
+  void ApplyWave(LevelWave_t const &wave);
 };
 
 #endif
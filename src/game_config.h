@@ -0,0 +1,48 @@
+#ifndef GAME_CONFIG_H
+#define GAME_CONFIG_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Startup options of the game, filled from the command line.
+ *
+ * The board can be much larger than the viewport; the renderer then follows
+ * the snake's head with a camera and only draws the visible tiles.
+ */
+typedef struct GameConfig {
+  std::size_t grid_width{32};
+  std::size_t grid_height{32};
+  std::size_t viewport_width{32};
+  std::size_t viewport_height{32};
+  std::size_t arena_snakes{0};
+  std::size_t threads{0};
+  unsigned server_port{0};
+  bool vsync{false};
+  // Draw in the terminal with ANSI escape codes instead of an SDL window.
+  bool terminal{false};
+  // Score database; empty for the default one.
+  std::string db_path;
+  // Print score analytics as JSON instead of playing.
+  bool stats{false};
+  // Publish live metrics through shared memory for SnakeMetrics.
+  bool metrics{false};
+  // Level pack to play from instead of the built-in levels; the pack sets the grid size.
+  std::string level_pack;
+  std::size_t pack_level{0};
+  // Directory to export a headless autopilot run to, as numbered images.
+  std::string export_directory;
+  std::size_t export_frames{600};
+  // File the game is checkpointed to, and a checkpoint to resume from (also checkpointed to).
+  std::string checkpoint_path;
+  std::string resume_path;
+  // Memory for the rewind history in KiB; 0 disables rewinding.
+  std::size_t rewind_kib{0};
+  // Foods kept on the board, and whether power-ups appear.
+  std::size_t foods{1};
+  bool power_ups{false};
+  // Recent games kept as raw entries per player and level; older ones are downsampled.
+  std::size_t score_history{100};
+} GameConfig_t;
+
+#endif /* GAME_CONFIG_H */
@@ -0,0 +1,216 @@
+#include "game_server.h"
+#include "frame_pacer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+std::atomic<bool> server_running{true};
+
+void StopServer(int) { server_running = false; }
+
+std::uint64_t AddressKey(const sockaddr_in &address) {
+  return (static_cast<std::uint64_t>(address.sin_addr.s_addr) << 16) | address.sin_port;
+}
+
+std::uint32_t NowMs(void) {
+  return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+}  // namespace
+
+/**
+ * @brief Opens a non-blocking UDP socket bound to localhost.
+ *
+ * If the socket can not be created or bound, a std::runtime_error exception will be thrown.
+ *
+ * @param grid_width The width of each game grid.
+ * @param grid_height The height of each game grid.
+ * @param port The UDP port to listen on.
+ */
+GameServer::GameServer(std::size_t grid_width, std::size_t grid_height, std::uint16_t port)
+    : grid_width(grid_width), grid_height(grid_height), buffer(Net::kMaxDatagram) {
+  socket_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  if (socket_fd < 0) {
+    throw std::runtime_error("Unable to create server socket");
+  }
+
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(socket_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+    close(socket_fd);
+    throw std::runtime_error("Unable to bind server socket");
+  }
+}
+
+GameServer::~GameServer() {
+  if (socket_fd >= 0) {
+    close(socket_fd);
+  }
+}
+
+/**
+ * @brief Runs the fixed-rate tick loop until the process receives SIGINT or SIGTERM.
+ *
+ * Each tick drains pending inputs, steps every game once and sends each client its snapshot.
+ *
+ * @param target_frame_duration The tick period in milliseconds; may be fractional.
+ */
+void GameServer::Run(double target_frame_duration) {
+  std::signal(SIGINT, StopServer);
+  std::signal(SIGTERM, StopServer);
+
+  FramePacer pacer(target_frame_duration);
+  auto report_time = std::chrono::steady_clock::now();
+  std::chrono::nanoseconds busy_time{0};
+  std::uint64_t report_ticks = 0;
+
+  std::cout << "Server listening on 127.0.0.1, press Ctrl+C to stop." << std::endl;
+  while (server_running) {
+    auto tick_start = std::chrono::steady_clock::now();
+    std::uint32_t now = NowMs();
+    tick++;
+
+    ReceiveInputs(now);
+    for (auto it = sessions.begin(); it != sessions.end();) {
+      if (now - it->second.last_heard > kSessionTimeoutMs) {
+        it = sessions.erase(it);
+        continue;
+      }
+      it->second.game->Step();
+      SendSnapshot(it->second);
+      ++it;
+    }
+
+    auto tick_end = std::chrono::steady_clock::now();
+    busy_time += tick_end - tick_start;
+    report_ticks++;
+    if (tick_end - report_time >= std::chrono::seconds(5)) {
+      std::cout << "Clients: " << sessions.size()
+                << ", tick CPU: " << std::chrono::duration_cast<std::chrono::microseconds>(busy_time).count() / report_ticks << " us"
+                << ", bytes per snapshot: " << (snapshots_sent ? bytes_sent / snapshots_sent : 0) << std::endl;
+      busy_time = std::chrono::nanoseconds{0};
+      report_ticks = 0;
+      bytes_sent = 0;
+      snapshots_sent = 0;
+      report_time = tick_end;
+    }
+
+    pacer.Wait();
+  }
+}
+
+/**
+ * @brief Reads every pending datagram from the socket.
+ *
+ * @param now The current time in milliseconds.
+ */
+void GameServer::ReceiveInputs(std::uint32_t now) {
+  Net::InputMessage message;
+  sockaddr_in address;
+  socklen_t address_size = sizeof(address);
+
+  while (true) {
+    ssize_t size = recvfrom(socket_fd, &message, sizeof(message), 0,
+                            reinterpret_cast<sockaddr *>(&address), &address_size);
+    if (size < 0) break;
+    if (static_cast<std::size_t>(size) != sizeof(message) || message.magic != Net::kMagic) continue;
+    HandleInput(address, message, now);
+    address_size = sizeof(address);
+  }
+}
+
+/**
+ * @brief Applies one client message, creating the client's game on first contact.
+ *
+ * @param address The client address.
+ * @param message The received message.
+ * @param now The current time in milliseconds.
+ */
+void GameServer::HandleInput(const sockaddr_in &address, const Net::InputMessage &message, std::uint32_t now) {
+  std::uint64_t key = AddressKey(address);
+  auto it = sessions.find(key);
+
+  if (message.type == Net::kBye) {
+    if (it != sessions.end()) sessions.erase(it);
+    return;
+  }
+  if (message.type != Net::kInput) return;
+
+  if (it == sessions.end()) {
+    int level = std::clamp<int>(message.level, 1, 3);
+    Session session{address, std::make_unique<Game>(grid_width, grid_height, level), message, now};
+    it = sessions.emplace(key, std::move(session)).first;
+  }
+
+  Session &session = it->second;
+  session.last_heard = now;
+  // Acknowledgements can arrive out of order; only ever move forward.
+  if (message.acked_tick >= session.ack.acked_tick) {
+    session.ack = message;
+  }
+  if (message.direction <= static_cast<std::uint8_t>(Snake::Direction::kRight)) {
+    std::lock_guard<std::mutex> lock(session.game->GetMutex());
+    session.game->Steer(static_cast<Snake::Direction>(message.direction));
+  }
+}
+
+/**
+ * @brief Sends a client what changed since its last acknowledged state.
+ *
+ * @param session The client session.
+ */
+void GameServer::SendSnapshot(Session &session) {
+  Game &game = *session.game;
+  std::lock_guard<std::mutex> lock(game.GetMutex());
+  Snake const &snake = game.GetSnake();
+  CellHashSet const &obstacles = game.GetObstacles();
+
+  Net::SnapshotHeader header{};
+  header.magic = Net::kMagic;
+  header.type = Net::kSnapshot;
+  header.flags = snake.alive ? Net::kAlive : 0;
+  header.tick = tick;
+  header.tail_index = snake.cells_added - snake.body.size();
+  header.first_index = std::max(session.ack.acked_cells, header.tail_index);
+  header.cell_count = static_cast<std::uint32_t>(std::min<std::uint64_t>(
+      snake.cells_added - std::min(header.first_index, snake.cells_added), Net::kMaxCellsPerMessage));
+  header.obstacle_version = game.GetObstacleVersion();
+  header.obstacle_total = static_cast<std::uint32_t>(obstacles.Size());
+  header.obstacle_offset = (session.ack.acked_obstacle_version == header.obstacle_version)
+                               ? std::min(session.ack.acked_obstacle_count, header.obstacle_total)
+                               : 0;
+  header.obstacle_count = static_cast<std::uint32_t>(std::min<std::size_t>(
+      header.obstacle_total - header.obstacle_offset, Net::kMaxCellsPerMessage - header.cell_count));
+  header.score = game.GetScore();
+  header.head = snake.HeadCell();
+  header.food = game.GetFood();
+
+  std::uint8_t *out = buffer.data();
+  std::memcpy(out, &header, sizeof(header));
+  out += sizeof(header);
+  if (header.cell_count > 0) {
+    std::memcpy(out, &snake.body[header.first_index - header.tail_index], header.cell_count * sizeof(Cell));
+    out += header.cell_count * sizeof(Cell);
+  }
+  if (header.obstacle_count > 0) {
+    std::memcpy(out, &obstacles.Cells()[header.obstacle_offset], header.obstacle_count * sizeof(Cell));
+    out += header.obstacle_count * sizeof(Cell);
+  }
+
+  std::size_t size = static_cast<std::size_t>(out - buffer.data());
+  if (sendto(socket_fd, buffer.data(), size, 0, reinterpret_cast<const sockaddr *>(&session.address),
+             sizeof(session.address)) >= 0) {
+    bytes_sent += size;
+    snapshots_sent++;
+  }
+}
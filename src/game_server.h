@@ -0,0 +1,57 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <netinet/in.h>
+#include "game.h"
+#include "net_protocol.h"
+
+/**
+ * @brief Headless authoritative server running one Game per client.
+ *
+ * The server owns the simulation: clients only send directions and receive
+ * delta-compressed snapshots (see net_protocol.h) once per tick over UDP on
+ * localhost. Clients are identified by their source address and are dropped
+ * after kSessionTimeoutMs without input.
+ */
+class GameServer {
+ public:
+  GameServer(std::size_t grid_width, std::size_t grid_height, std::uint16_t port);
+  ~GameServer();
+
+  GameServer(const GameServer &other) = delete;
+  GameServer &operator=(const GameServer &other) = delete;
+
+  void Run(double target_frame_duration);
+
+ private:
+  static constexpr std::uint32_t kSessionTimeoutMs{5000};
+
+  struct Session {
+    sockaddr_in address;
+    std::unique_ptr<Game> game;
+    Net::InputMessage ack;
+    std::uint32_t last_heard;
+  };
+
+  std::size_t grid_width;
+  std::size_t grid_height;
+  int socket_fd{-1};
+  std::uint64_t tick{0};
+  std::unordered_map<std::uint64_t, Session> sessions;
+  std::vector<std::uint8_t> buffer;
+
+  // Statistics for the periodic report.
+  std::uint64_t bytes_sent{0};
+  std::uint64_t snapshots_sent{0};
+
+  void ReceiveInputs(std::uint32_t now);
+  void HandleInput(const sockaddr_in &address, const Net::InputMessage &message, std::uint32_t now);
+  void SendSnapshot(Session &session);
+};
+
+#endif /* GAME_SERVER_H */
@@ -0,0 +1,84 @@
+#include "item_board.h"
+
+/**
+ * @brief Creates an empty board of items.
+ *
+ * @param width The width of the board in cells.
+ * @param height The height of the board in cells.
+ */
+ItemBoard::ItemBoard(int width, int height)
+    : width(width), slots(static_cast<std::size_t>(width) * height, kNone) {}
+
+/**
+ * @brief Returns the item on a cell.
+ *
+ * @param cell The cell.
+ *
+ * @return The item, or nullptr if the cell holds none; valid until the items change.
+ */
+const Item_t *ItemBoard::Find(Cell cell) const {
+  std::uint32_t const slot = slots[Index(cell)];
+  return slot == kNone ? nullptr : &items[slot];
+}
+
+/**
+ * @brief Adds an item.
+ *
+ * @param item The item.
+ *
+ * @return False if its cell already holds an item.
+ */
+bool ItemBoard::Add(Item_t const &item) {
+  std::uint32_t &slot = slots[Index(item.cell)];
+  if (slot != kNone) return false;
+  slot = static_cast<std::uint32_t>(items.size());
+  items.push_back(item);
+  counts[static_cast<std::size_t>(item.kind)]++;
+  return true;
+}
+
+/**
+ * @brief Removes the item on a cell, moving the last item into its slot.
+ *
+ * @param cell The cell.
+ * @param removed Receives the removed item.
+ *
+ * @return False if the cell holds no item.
+ */
+bool ItemBoard::Remove(Cell cell, Item_t &removed) {
+  std::uint32_t const slot = slots[Index(cell)];
+  if (slot == kNone) return false;
+  removed = items[slot];
+  slots[Index(cell)] = kNone;
+  if (slot + 1 != items.size()) {
+    items[slot] = items.back();
+    slots[Index(items[slot].cell)] = slot;
+  }
+  items.pop_back();
+  counts[static_cast<std::size_t>(removed.kind)]--;
+  return true;
+}
+
+/**
+ * @brief Replaces every item.
+ *
+ * @param new_items The items; of several on one cell, only the first is kept.
+ */
+void ItemBoard::Assign(std::vector<Item_t> const &new_items) {
+  Clear();
+  items.reserve(new_items.size());
+  for (Item_t const &item : new_items) {
+    Add(item);
+  }
+}
+
+/**
+ * @brief Removes every item; only the cells that held one are touched.
+ */
+void ItemBoard::Clear(void) {
+  for (Item_t const &item : items) {
+    slots[Index(item.cell)] = kNone;
+  }
+  items.clear();
+  counts.fill(0);
+}
@@ -0,0 +1,59 @@
+#ifndef ITEM_BOARD_H
+#define ITEM_BOARD_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cell.h"
+
+// What eating an item does: food grows the snake; the power-ups speed it up for a while, cut
+// off part of its tail, or let it pass through obstacles for a while.
+enum class ItemKind : std::uint8_t { kFood, kSpeed, kShrink, kGhost };
+constexpr std::size_t kItemKinds{4};
+
+/**
+ * @brief One consumable item on the board.
+ */
+typedef struct Item {
+  Cell cell;
+  ItemKind kind{ItemKind::kFood};
+  std::uint64_t expires{0};  // Tick on which the item disappears; 0 if it stays until eaten
+} Item_t;
+
+/**
+ * @brief The consumable items on a board: foods and power-ups.
+ *
+ * Items are stored densely in one array, so drawing iterates them without
+ * gaps, and a grid of slot indices maps every cell to the item on it, like the
+ * arena's occupancy grid. Looking up, adding and removing an item are O(1)
+ * whatever the number of items; removing moves the last item into the freed
+ * slot.
+ */
+class ItemBoard {
+ public:
+  ItemBoard(int width, int height);
+
+  const Item_t *Find(Cell cell) const;
+  bool Contains(Cell cell) const { return slots[Index(cell)] != kNone; }
+  bool Add(Item_t const &item);
+  bool Remove(Cell cell, Item_t &removed);
+  void Assign(std::vector<Item_t> const &new_items);
+  void Clear(void);
+
+  std::vector<Item_t> const &Items(void) const { return items; }
+  std::size_t Size(void) const { return items.size(); }
+  std::size_t Count(ItemKind kind) const { return counts[static_cast<std::size_t>(kind)]; }
+
+ private:
+  static constexpr std::uint32_t kNone{0xFFFFFFFFu};
+
+  int width;
+  std::vector<Item_t> items;
+  std::vector<std::uint32_t> slots;  // Index into items of the item on each cell, or kNone
+  std::array<std::size_t, kItemKinds> counts{};
+
+  std::size_t Index(Cell cell) const { return static_cast<std::size_t>(cell.y) * width + cell.x; }
+};
+
+#endif /* ITEM_BOARD_H */
@@ -0,0 +1,268 @@
+#include "level_pack.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace LevelPackFormat;
+
+namespace {
+std::uint64_t AlignUp(std::uint64_t value) { return (value + 7) & ~std::uint64_t{7}; }
+
+std::uint64_t WallWordCount(int width, int height) {
+  return (static_cast<std::uint64_t>(width) * height + 63) / 64;
+}
+
+bool InRange(std::uint64_t offset, std::uint64_t bytes, std::size_t size) {
+  return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+}
+
+bool CellsInside(const std::uint8_t *base, std::uint64_t offset, std::size_t count, const LevelRecord &record) {
+  for (std::size_t i = 0; i < count; ++i) {
+    Cell cell;
+    std::memcpy(&cell, base + offset + i * sizeof(Cell), sizeof(Cell));
+    if (cell.x >= record.width || cell.y >= record.height) return false;
+  }
+  return true;
+}
+}  // namespace
+
+/**
+ * @brief Returns the name of the level.
+ */
+std::string PackedLevel::Name(void) const {
+  return std::string(record->name, strnlen(record->name, kNameLength));
+}
+
+/**
+ * @brief Returns the wall bitmap of the level.
+ */
+const std::uint64_t *PackedLevel::WallWords(void) const {
+  return reinterpret_cast<const std::uint64_t *>(base + record->wall_offset);
+}
+
+/**
+ * @brief Checks the wall bitmap for a cell.
+ *
+ * @param cell The cell to check; must be inside the level.
+ *
+ * @return True if the cell is a wall.
+ */
+bool PackedLevel::IsWall(Cell cell) const {
+  std::uint64_t bit = static_cast<std::uint64_t>(cell.y) * record->width + cell.x;
+  return (WallWords()[bit / 64] >> (bit % 64)) & 1u;
+}
+
+/**
+ * @brief Appends the cells of all walls, in row-major order.
+ *
+ * Only set bits are visited, so sparse maps decode in time proportional to the number of words
+ * plus the number of walls.
+ *
+ * @param cells The vector to append to.
+ */
+void PackedLevel::AppendWalls(std::vector<Cell> &cells) const {
+  const std::uint64_t *words = WallWords();
+  std::uint64_t const word_count = WallWordCount(record->width, record->height);
+  for (std::uint64_t w = 0; w < word_count; ++w) {
+    std::uint64_t bits = words[w];
+    while (bits != 0) {
+      std::uint64_t bit = w * 64 + __builtin_ctzll(bits);
+      cells.emplace_back(static_cast<int>(bit % record->width), static_cast<int>(bit / record->width));
+      bits &= bits - 1;
+    }
+  }
+}
+
+/**
+ * @brief Returns a spawn point of the level.
+ *
+ * @param index The index of the spawn point, below SpawnCount().
+ */
+Cell PackedLevel::Spawn(std::size_t index) const {
+  Cell cell;
+  std::memcpy(&cell, base + record->spawn_offset + index * sizeof(Cell), sizeof(Cell));
+  return cell;
+}
+
+/**
+ * @brief Returns an obstacle wave of the level.
+ *
+ * @param index The index of the wave, below WaveCount(). Waves are sorted by time.
+ */
+LevelWave_t PackedLevel::Wave(std::size_t index) const {
+  const WaveRecord *wave = reinterpret_cast<const WaveRecord *>(base + record->wave_offset) + index;
+  return LevelWave_t{wave->at_ms, reinterpret_cast<const Cell *>(base + wave->cell_offset), wave->cell_count};
+}
+
+/**
+ * @brief Maps a level pack into memory.
+ *
+ * @param path The path of the pack file.
+ *
+ * @throws std::runtime_error If the file can not be mapped or is not a valid pack.
+ */
+LevelPack::LevelPack(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Unable to open level pack " + path);
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(PackHeader))) {
+    close(fd);
+    throw std::runtime_error("Level pack is too small: " + path);
+  }
+  size = static_cast<std::size_t>(info.st_size);
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw std::runtime_error("Unable to map level pack " + path);
+  }
+  data = static_cast<const std::uint8_t *>(mapping);
+  header = reinterpret_cast<const PackHeader *>(data);
+
+  try {
+    Validate();
+  } catch (const std::runtime_error &) {
+    munmap(const_cast<std::uint8_t *>(data), size);
+    throw;
+  }
+}
+
+/**
+ * @brief Unmaps the pack; views returned by Level() become invalid.
+ */
+LevelPack::~LevelPack() {
+  munmap(const_cast<std::uint8_t *>(data), size);
+}
+
+/**
+ * @brief Checks that every section of the pack lies inside the file.
+ *
+ * Spawn and wave cells are also checked against the level size, so the game can use them
+ * without further checks.
+ *
+ * @throws std::runtime_error If the pack is malformed.
+ */
+void LevelPack::Validate(void) const {
+  if (header->magic != kMagic || header->version != kVersion || header->file_size != size) {
+    throw std::runtime_error("Not a level pack, or written by another version");
+  }
+  if (!InRange(sizeof(PackHeader), header->level_count * sizeof(LevelRecord), size)) {
+    throw std::runtime_error("Level pack is truncated");
+  }
+  for (std::size_t i = 0; i < header->level_count; ++i) {
+    const LevelRecord &record = reinterpret_cast<const LevelRecord *>(data + sizeof(PackHeader))[i];
+    bool valid = record.width > 0 && record.height > 0 &&
+                 InRange(record.wall_offset, WallWordCount(record.width, record.height) * 8, size) &&
+                 InRange(record.spawn_offset, record.spawn_count * sizeof(Cell), size) &&
+                 InRange(record.wave_offset, record.wave_count * sizeof(WaveRecord), size) &&
+                 CellsInside(data, record.spawn_offset, record.spawn_count, record);
+    for (std::size_t w = 0; valid && w < record.wave_count; ++w) {
+      const WaveRecord &wave = reinterpret_cast<const WaveRecord *>(data + record.wave_offset)[w];
+      valid = InRange(wave.cell_offset, wave.cell_count * sizeof(Cell), size) &&
+              CellsInside(data, wave.cell_offset, wave.cell_count, record);
+    }
+    if (!valid) {
+      throw std::runtime_error("Level " + std::to_string(i) + " of the level pack is corrupt");
+    }
+  }
+}
+
+/**
+ * @brief Returns a view of one level.
+ *
+ * @param index The index of the level, below Size().
+ *
+ * @throws std::runtime_error If the index is out of range.
+ */
+PackedLevel LevelPack::Level(std::size_t index) const {
+  if (index >= header->level_count) {
+    throw std::runtime_error("Level pack has no level " + std::to_string(index));
+  }
+  return PackedLevel(data, reinterpret_cast<const LevelRecord *>(data + sizeof(PackHeader)) + index);
+}
+
+/**
+ * @brief Writes levels to a new pack file.
+ *
+ * @param path The path of the file to create.
+ * @param levels The levels to store, in index order.
+ *
+ * @throws std::runtime_error If a level is invalid or the file can not be written.
+ */
+void LevelPack::Write(const std::string &path, const std::vector<LevelSource_t> &levels) {
+  if (levels.size() > 0xFFFF) {
+    throw std::runtime_error("Too many levels for one pack");
+  }
+
+  // Lay out the header and level table first, then each level's sections.
+  std::vector<LevelRecord> records(levels.size());
+  std::vector<std::vector<WaveRecord>> waves(levels.size());
+  std::uint64_t offset = AlignUp(sizeof(PackHeader) + levels.size() * sizeof(LevelRecord));
+  for (std::size_t i = 0; i < levels.size(); ++i) {
+    const LevelSource_t &level = levels[i];
+    // The level table stores sizes in 16 bits, so a full kMaxGridSide side does not fit.
+    if (level.width <= 0 || level.height <= 0 || level.width >= Cell::kMaxGridSide ||
+        level.height >= Cell::kMaxGridSide) {
+      throw std::runtime_error("Level " + level.name + " has an invalid size");
+    }
+    LevelRecord &record = records[i];
+    std::memset(&record, 0, sizeof(record));
+    std::strncpy(record.name, level.name.c_str(), kNameLength - 1);
+    record.width = static_cast<std::uint16_t>(level.width);
+    record.height = static_cast<std::uint16_t>(level.height);
+    record.wall_offset = offset;
+    offset += WallWordCount(level.width, level.height) * 8;
+    record.spawn_offset = offset;
+    record.spawn_count = static_cast<std::uint32_t>(level.spawns.size());
+    offset = AlignUp(offset + level.spawns.size() * sizeof(Cell));
+    record.wave_offset = offset;
+    record.wave_count = static_cast<std::uint32_t>(level.waves.size());
+    record.repeat_ms = level.repeat_ms;
+    offset += level.waves.size() * sizeof(WaveRecord);
+    for (auto const &wave : level.waves) {
+      waves[i].push_back(WaveRecord{wave.first, static_cast<std::uint32_t>(wave.second.size()), offset});
+      offset = AlignUp(offset + wave.second.size() * sizeof(Cell));
+    }
+  }
+
+  std::vector<std::uint8_t> file(offset, 0);
+  PackHeader header{kMagic, kVersion, static_cast<std::uint16_t>(levels.size()), offset};
+  std::memcpy(file.data(), &header, sizeof(header));
+  for (std::size_t i = 0; i < levels.size(); ++i) {
+    const LevelSource_t &level = levels[i];
+    LevelRecord &record = records[i];
+    std::uint64_t *words = reinterpret_cast<std::uint64_t *>(file.data() + record.wall_offset);
+    for (Cell const &wall : level.walls) {
+      if (wall.x >= level.width || wall.y >= level.height) {
+        throw std::runtime_error("Level " + level.name + " has a wall outside the board");
+      }
+      std::uint64_t bit = static_cast<std::uint64_t>(wall.y) * level.width + wall.x;
+      if (((words[bit / 64] >> (bit % 64)) & 1u) == 0) {
+        words[bit / 64] |= std::uint64_t{1} << (bit % 64);
+        record.wall_count++;
+      }
+    }
+    if (!level.spawns.empty()) {
+      std::memcpy(file.data() + record.spawn_offset, level.spawns.data(), level.spawns.size() * sizeof(Cell));
+    }
+    for (std::size_t w = 0; w < waves[i].size(); ++w) {
+      std::memcpy(file.data() + record.wave_offset + w * sizeof(WaveRecord), &waves[i][w], sizeof(WaveRecord));
+      auto const &cells = level.waves[w].second;
+      if (!cells.empty()) {
+        std::memcpy(file.data() + waves[i][w].cell_offset, cells.data(), cells.size() * sizeof(Cell));
+      }
+    }
+    std::memcpy(file.data() + sizeof(PackHeader) + i * sizeof(LevelRecord), &record, sizeof(record));
+  }
+
+  std::ofstream output(path, std::ios::binary | std::ios::trunc);
+  output.write(reinterpret_cast<const char *>(file.data()), static_cast<std::streamsize>(file.size()));
+  if (!output) {
+    throw std::runtime_error("Unable to write level pack " + path);
+  }
+}
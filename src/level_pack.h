@@ -0,0 +1,137 @@
+#ifndef LEVEL_PACK_H
+#define LEVEL_PACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "cell.h"
+
+/**
+ * @brief Binary file holding many hand-made levels.
+ *
+ * The file is memory-mapped and read in place; opening it only checks that
+ * every offset stays inside the file. All values are in host byte order and
+ * every section is 8-byte aligned:
+ * - PackHeader, followed by one LevelRecord per level;
+ * - per level, a wall bitmap of width * height bits in row-major order,
+ *   packed into 64-bit words;
+ * - per level, its spawn cells, its WaveRecords and the cells of all waves.
+ *
+ * Levels are written by SnakeLevelCompiler (tools/level_compiler.cpp) from
+ * ASCII-art maps.
+ */
+namespace LevelPackFormat {
+
+constexpr std::uint32_t kMagic{0x31504C53u};  // "SLP1"
+constexpr std::uint16_t kVersion{1};
+constexpr std::size_t kNameLength{32};
+
+struct PackHeader {
+  std::uint32_t magic;
+  std::uint16_t version;
+  std::uint16_t level_count;
+  std::uint64_t file_size;
+};
+
+struct LevelRecord {
+  char name[kNameLength];      // Zero-terminated
+  std::uint16_t width;
+  std::uint16_t height;
+  std::uint32_t wall_count;    // Number of set bits in the wall bitmap
+  std::uint64_t wall_offset;   // Offsets are from the start of the file
+  std::uint64_t spawn_offset;
+  std::uint64_t wave_offset;
+  std::uint32_t spawn_count;
+  std::uint32_t wave_count;
+  std::uint32_t repeat_ms;     // Waves restart after this period; 0 plays them once
+  std::uint32_t reserved;
+};
+
+struct WaveRecord {
+  std::uint32_t at_ms;         // Time since the level started
+  std::uint32_t cell_count;
+  std::uint64_t cell_offset;
+};
+
+}  // namespace LevelPackFormat
+
+/**
+ * @brief Obstacles added at a given time; they replace the previous wave.
+ */
+typedef struct LevelWave {
+  std::uint32_t at_ms;
+  const Cell *cells;
+  std::size_t cell_count;
+} LevelWave_t;
+
+/**
+ * @brief Read-only view of one level inside a mapped pack.
+ *
+ * The view points into the mapping and is valid while its LevelPack lives.
+ */
+class PackedLevel {
+ public:
+  PackedLevel(const std::uint8_t *base, const LevelPackFormat::LevelRecord *record)
+      : base(base), record(record) {}
+
+  std::string Name(void) const;
+  int Width(void) const { return record->width; }
+  int Height(void) const { return record->height; }
+  bool IsWall(Cell cell) const;
+  void AppendWalls(std::vector<Cell> &cells) const;
+  std::size_t WallCount(void) const { return record->wall_count; }
+
+  std::size_t SpawnCount(void) const { return record->spawn_count; }
+  Cell Spawn(std::size_t index) const;
+
+  std::size_t WaveCount(void) const { return record->wave_count; }
+  LevelWave_t Wave(std::size_t index) const;
+  std::uint32_t RepeatMs(void) const { return record->repeat_ms; }
+
+ private:
+  const std::uint64_t *WallWords(void) const;
+
+  const std::uint8_t *base;
+  const LevelPackFormat::LevelRecord *record;
+};
+
+/**
+ * @brief Level description used to build a pack.
+ */
+typedef struct LevelSource {
+  std::string name;
+  int width{0};
+  int height{0};
+  std::vector<Cell> walls;
+  std::vector<Cell> spawns;
+  std::vector<std::pair<std::uint32_t, std::vector<Cell>>> waves;  // (at_ms, cells), sorted by time
+  std::uint32_t repeat_ms{0};
+} LevelSource_t;
+
+/**
+ * @brief Memory-mapped level pack.
+ */
+class LevelPack {
+ public:
+  explicit LevelPack(const std::string &path);
+  ~LevelPack();
+
+  LevelPack(const LevelPack &) = delete;
+  LevelPack &operator=(const LevelPack &) = delete;
+
+  std::size_t Size(void) const { return header->level_count; }
+  PackedLevel Level(std::size_t index) const;
+
+  static void Write(const std::string &path, const std::vector<LevelSource_t> &levels);
+
+ private:
+  const std::uint8_t *data{nullptr};
+  std::size_t size{0};
+  const LevelPackFormat::PackHeader *header{nullptr};
+
+  void Validate(void) const;
+};
+
+#endif /* LEVEL_PACK_H */
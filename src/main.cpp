@@ -1,33 +1,184 @@
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <future>
 #include <iostream>
 #include <string>
+#include <thread>
+#include "arena.h"
+#include "game_server.h"
 #include "menu_choices.h"
 #include "controller.h"
+#include "frame_exporter.h"
 #include "game.h"
+#include "level_pack.h"
+#include "metrics.h"
 #include "renderer.h"
+#include "score_analytics.h"
+#include "parser_string.h"
 
 #define SNAKE_GAME_DB "../src/game_db.json"
 
 int main(int argc, char **argv) {
   constexpr std::size_t kFramesPerSecond{60};
-  constexpr std::size_t kMsPerFrame{1000 / kFramesPerSecond};
+  constexpr double kMsPerFrame{1000.0 / kFramesPerSecond};
   constexpr std::size_t kScreenWidth{640};
   constexpr std::size_t kScreenHeight{640};
-  constexpr std::size_t kGridWidth{32};
-  constexpr std::size_t kGridHeight{32};
+  GameConfig_t config;
   std::string player_name;
+
+  if (!Parser::ParseCommandLine(argc, argv, config)) {
+    std::cerr << "Usage: " << argv[0] << " [--grid <width>x<height>] [--viewport <width>x<height>]"
+              << " [--arena <snakes>] [--threads <count>] [--server <port>] [--vsync] [--terminal] [--metrics]"
+              << " [--db <file>] [--stats]"
+              << " [--pack <file> [--pack-level <index>]] [--export <directory> [--export-frames <count>]]"
+              << " [--checkpoint <file>] [--resume <file>] [--rewind-memory <KiB>] [--foods <count>] [--power-ups]"
+              << " [--score-history <games>]"
+              << std::endl;
+    return 1;
+  }
+  if (config.viewport_width > kScreenWidth || config.viewport_height > kScreenHeight) {
+    std::cerr << "Viewport can not show more than one cell per pixel." << std::endl;
+    return 1;
+  }
+  Renderer::Backend const backend = config.terminal ? Renderer::Backend::kTerminal : Renderer::Backend::kWindow;
+
+  if (config.metrics) {
+    if (Metrics::Open()) {
+      std::atexit(Metrics::Close);
+    } else {
+      std::cerr << "Unable to create the shared-memory metrics segment." << std::endl;
+    }
+  }
+
+  std::string const db_path = config.db_path.empty() ? SNAKE_GAME_DB : config.db_path;
+
+  // Score analytics are printed as JSON, without a window or menu.
+  if (config.stats) {
+    std::ifstream db(db_path);
+    if (!db.is_open()) {
+      std::cerr << "Unable to open " << db_path << std::endl;
+      return 1;
+    }
+    ScoreAnalytics analytics(config.threads ? config.threads : std::thread::hardware_concurrency(), std::cout);
+    if (!analytics.Run(db)) {
+      std::cerr << "Score database " << db_path << " is not valid JSON." << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  // The tick server runs headless: no menu, window or score database.
+  if (config.server_port > 0) {
+    try {
+      GameServer server(config.grid_width, config.grid_height, static_cast<std::uint16_t>(config.server_port));
+      server.Run(kMsPerFrame);
+    } catch (const std::runtime_error &error) {
+      std::cerr << error.what() << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+
+  // The AI arena skips the menu and the score database.
+  if (config.arena_snakes > 0) {
+    std::size_t threads = config.threads ? config.threads : std::thread::hardware_concurrency();
+    auto renderer = std::make_unique<Renderer>(kScreenWidth, kScreenHeight, config.grid_width, config.grid_height,
+                                               config.viewport_width, config.viewport_height, config.vsync, backend);
+    auto controller = std::make_unique<Controller>(config.terminal);
+    auto arena = std::make_unique<Arena>(config.grid_width, config.grid_height, config.arena_snakes, threads);
+    renderer->Show();
+    arena->Run(*controller, *renderer, kMsPerFrame);
+    return 0;
+  }
   
-  // Create the menu game
-  MenuChoice game_menu(SNAKE_GAME_DB);
-  game_menu.MenuProcess(); 
-  
+  // A level from a pack brings its own board size.
+  std::unique_ptr<LevelPack> level_pack;
+  if (!config.level_pack.empty()) {
+    try {
+      level_pack = std::make_unique<LevelPack>(config.level_pack);
+      PackedLevel level = level_pack->Level(config.pack_level);
+      config.grid_width = level.Width();
+      config.grid_height = level.Height();
+    } catch (const std::runtime_error &error) {
+      std::cerr << error.what() << std::endl;
+      return 1;
+    }
+  }
+
+  // Export records an autopilot run without a window, menu or score database.
+  if (!config.export_directory.empty()) {
+    std::size_t threads = config.threads ? config.threads : std::thread::hardware_concurrency();
+    auto game = level_pack ? std::make_unique<Game>(level_pack->Level(config.pack_level), 1)
+                           : std::make_unique<Game>(config.grid_width, config.grid_height, 1);
+    FrameExporter exporter(config.export_directory, kScreenWidth, kScreenHeight, config.grid_width,
+                           config.grid_height, config.viewport_width, config.viewport_height, threads);
+    auto start = std::chrono::steady_clock::now();
+    game->EnableItems(config.foods, config.power_ups);
+    std::size_t frames = game->Record(exporter, config.export_frames);
+    exporter.Finish();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Exported " << exporter.Written() << " of " << frames << " frames to " << config.export_directory
+              << " in " << seconds << " s (" << exporter.Written() / seconds << " frames/s, " << threads
+              << " encoder threads), score " << game->GetScore() << std::endl;
+    return exporter.Failed() == 0 ? 0 : 1;
+  }
+
+  // A resumed game brings its own board size and level, and skips the menu.
+  GameState_t resume_state;
+  bool const resuming = !config.resume_path.empty();
+  if (resuming) {
+    if (!CheckpointWriter::Load(config.resume_path, resume_state)) {
+      std::cerr << "No valid checkpoint in " << config.resume_path << std::endl;
+      return 1;
+    }
+    config.grid_width = resume_state.scalars.grid_width;
+    config.grid_height = resume_state.scalars.grid_height;
+  }
+
+  // Create the menu game. The score database loads in the background and the
+  // menu runs on its own thread, so SDL video init and window creation overlap
+  // with the player reading the menu.
+  MenuChoice game_menu(db_path);
+  std::future<void> menu_done;
+  if (!resuming) {
+    menu_done = std::async(std::launch::async, [&game_menu] { game_menu.MenuProcess(); });
+  }
+  auto renderer = std::make_unique<Renderer>(kScreenWidth, kScreenHeight, config.grid_width, config.grid_height,
+                                             config.viewport_width, config.viewport_height, config.vsync, backend);
+  if (!resuming) {
+    menu_done.get();
+  }
+
   // Check if user choice run game then create object to run game
-  if (game_menu.GetGameState()) {
-    auto renderer = std::make_unique<Renderer>(kScreenWidth, kScreenHeight, kGridWidth, kGridHeight);
-    auto controller = std::make_unique<Controller>();
-    auto game = std::make_unique<Game>(kGridWidth, kGridHeight, game_menu.GetCurrentLevel());
+  if (resuming || game_menu.GetGameState()) {
+    renderer->Show();
+    auto controller = std::make_unique<Controller>(config.terminal);
+    int const level = resuming ? resume_state.scalars.level : game_menu.GetCurrentLevel();
+    auto game = resuming     ? std::make_unique<Game>(resume_state)
+                : level_pack ? std::make_unique<Game>(level_pack->Level(config.pack_level), level)
+                             : std::make_unique<Game>(config.grid_width, config.grid_height, level);
+    std::string const &checkpoint_path = config.checkpoint_path.empty() ? config.resume_path : config.checkpoint_path;
+    if (!checkpoint_path.empty()) {
+      try {
+        game->EnableCheckpoints(checkpoint_path);
+      } catch (const std::runtime_error &error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+      }
+    }
+    game->EnableItems(config.foods, config.power_ups);
+    if (config.rewind_kib > 0) {
+      game->EnableRewind(config.rewind_kib * 1024);
+    }
 
     game->Run(*controller, *renderer, kMsPerFrame);
 
+    if (config.terminal) {
+      // Give the terminal back before asking for the player's name.
+      controller.reset();
+      renderer.reset();
+    }
     std::cout << "Game has terminated successfully!" << std::endl;
   
     std::cout << "Enter your name to save score:" << std::endl;
@@ -36,8 +187,8 @@ int main(int argc, char **argv) {
     std::cout << "Size: " << game->GetSize() << "\n";
 
     // Save player's score to game database with current level and score.
-    PlayerInfo_t player{player_name, game_menu.GetCurrentLevel(), game->GetScore(), game->GetSize()};
-    game->SaveGame(SNAKE_GAME_DB, player);
+    PlayerInfo_t player{player_name, level, game->GetScore(), game->GetSize()};
+    game->SaveGame(db_path, player, config.score_history);
   }
 
   return 0;
@@ -2,14 +2,40 @@
 #include <iostream>
 #include "manager_db.h"
 
+/**
+ * @brief Constructs the database and starts loading the file on a background thread.
+ *
+ * The constructor returns immediately; every accessor waits for the load to finish, so callers
+ * that never read the database never wait for it. A load error is reported by the first accessor.
+ *
+ * @param file_path The path to the JSON database file.
+ */
 ManagerDBJson::ManagerDBJson(std::string file_path):file_path_(file_path)
 {
-    LoadJsonFile();
+    load_result_ = std::async(std::launch::async, &ManagerDBJson::LoadJsonFile, this);
 }
 
 ManagerDBJson::~ManagerDBJson()
 {
+    if (load_result_.valid()) {
+        load_result_.wait();
+    }
+}
 
+/**
+ * @brief Waits for the background load started by the constructor.
+ *
+ * If the load failed, its std::runtime_error exception is rethrown here, once.
+ *
+ * @param None
+ *
+ * @return void
+ */
+void ManagerDBJson::WaitLoaded(void)
+{
+    if (load_result_.valid()) {
+        load_result_.get();
+    }
 }
 
 /**
@@ -17,7 +43,7 @@ ManagerDBJson::~ManagerDBJson()
  *
  * This function updates the JSON data with the provided key and value.
  * If the key already exists, its value will be replaced. If the key does not exist,
- * it will be added to the JSON data.
+ * it will be added to the JSON data. The player index is kept up to date.
  *
  * @param key The key to update or add in the JSON data.
  * @param value The value to associate with the given key in the JSON data.
@@ -26,7 +52,15 @@ ManagerDBJson::~ManagerDBJson()
  */
 void ManagerDBJson::UpdateJsonFile(const std::string &key, const json &value)
 {
+    WaitLoaded();
+    bool const was_object = json_data_.is_object();
     json_data_[key] = value;
+    if (was_object) {
+        auto it = json_data_.find(key);
+        index_.Insert(it.key(), it.value());
+    } else {
+        index_.Build(json_data_);
+    }
 }
 
 /**
@@ -41,6 +75,7 @@ void ManagerDBJson::UpdateJsonFile(const std::string &key, const json &value)
  */
 json ManagerDBJson::ReadJsonFile(const std::string &key)
 {
+    WaitLoaded();
     if (json_data_.contains(key)) {
         return json_data_[key];
     } else {
@@ -51,8 +86,8 @@ json ManagerDBJson::ReadJsonFile(const std::string &key)
 /**
  * @brief Loads the JSON data from the specified file.
  *
- * This function reads the JSON data from the specified file and stores it in the internal data structure.
- * If the file cannot be opened, a std::runtime_error exception will be thrown.
+ * This function reads the JSON data from the specified file and stores it in the internal data structure,
+ * then builds the player index over it. If the file cannot be opened, a std::runtime_error exception will be thrown.
  *
  * @param None
  *
@@ -64,6 +99,7 @@ void ManagerDBJson::LoadJsonFile(void)
     if (file.is_open()) {
         file >> json_data_;
         file.close();
+        index_.Build(json_data_);
     } else {
         throw std::runtime_error("Unable to open file");
     }
@@ -81,6 +117,7 @@ void ManagerDBJson::LoadJsonFile(void)
  */
 void ManagerDBJson::SaveJsonFile(void)
 {
+    WaitLoaded();
     std::ofstream file(file_path_);
     if (file.is_open()) {
         file << json_data_.dump(4);
@@ -100,5 +137,38 @@ void ManagerDBJson::SaveJsonFile(void)
  */
 json ManagerDBJson::ReadAllJsonFile(void)
 {
+    WaitLoaded();
     return json_data_;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Looks up a player by exact name through the player index.
+ *
+ * @param name The player's name.
+ *
+ * @return The player's scores, or nullptr if there is no such player; valid until the data changes.
+ */
+const json *ManagerDBJson::FindPlayer(const std::string &name)
+{
+    WaitLoaded();
+    return index_.Find(name);
+}
+
+/**
+ * @brief Lists one page of the players whose names start with a prefix, in name order.
+ *
+ * This function takes O(log n + limit) time whatever the number of players.
+ *
+ * @param prefix The prefix; empty lists every player.
+ * @param offset The number of matching players to skip.
+ * @param limit The largest number of players to list.
+ * @param page Receives the players; valid until the data changes.
+ *
+ * @return The number of players matching the prefix.
+ */
+std::size_t ManagerDBJson::ListPlayers(const std::string &prefix, std::size_t offset, std::size_t limit,
+                                       std::vector<PlayerIndex::Entry_t> &page)
+{
+    WaitLoaded();
+    return index_.Page(prefix, offset, limit, page);
+}
@@ -1,8 +1,11 @@
 #ifndef MANAGER_DB_H
 #define MANAGER_DB_H
 
+#include <future>
 #include <string>
+#include <vector>
 #include <nlohmann/json.hpp>
+#include "player_index.h"
 
 using json = nlohmann::json;
 
@@ -14,11 +17,17 @@ class ManagerDBJson {
         json ReadJsonFile(const std::string &key);
         void SaveJsonFile(void);
         json ReadAllJsonFile(void);
+        const json *FindPlayer(const std::string &name);
+        std::size_t ListPlayers(const std::string &prefix, std::size_t offset, std::size_t limit,
+                                std::vector<PlayerIndex::Entry_t> &page);
 
     private:
         std::string file_path_;
         json json_data_;
+        PlayerIndex index_;
+        std::future<void> load_result_;
         void LoadJsonFile(void);
+        void WaitLoaded(void);
 };
 
 
@@ -1,8 +1,24 @@
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <vector>
 #include "menu_choices.h"
+#include "parser_string.h"
+#include "score_history.h"
 #include "system_common.h"
 
+/**
+ * @brief Returns a player's best score on a level, or -1 if the player never played it.
+ *
+ * @param scores The player's entry in the database.
+ * @param level The level name.
+ */
+static int LevelBest(const json &scores, const char *level)
+{
+    auto it = scores.find(level);
+    return (it == scores.end()) ? -1 : ScoreHistory::Best(*it);
+}
+
 /**
  * @brief Constructs a new MenuChoice object.
  *
@@ -247,15 +263,15 @@ bool MenuChoice::GetGameState(void)
  * @brief Displays the score menu and handles user choices for viewing scores.
  *
  * This function presents the user with a menu to view scores. The user can choose to:
- * - View all scores
+ * - View all scores, one page of players at a time
  * - View the maximum score
+ * - Find a player by name or by the beginning of a name
  * - Return to the main menu
  */
 void MenuChoice::PrintMenuScore(void)
 {
     int choice = 0;
-    json js_all;
-    int index = 0;
+    std::vector<PlayerIndex::Entry_t> players;
     int score_hard = 0;
     int score_easy = 0;
     int score_medium = 0;
@@ -263,7 +279,8 @@ void MenuChoice::PrintMenuScore(void)
     std::cout << "*** Menu score ***" << std::endl;
     std::cout << "1. View all score" << std::endl;
     std::cout << "2. View maximum score" << std::endl;
-    std::cout << "3. Back to menu" << std::endl;
+    std::cout << "3. Find player" << std::endl;
+    std::cout << "4. Back to menu" << std::endl;
     std::cout << "Enter your choice: ";
 
     std::cin >> choice;
@@ -271,53 +288,21 @@ void MenuChoice::PrintMenuScore(void)
     switch (choice)
     {
         case 1:
-            js_all = ReadAllJsonFile();
-            std::cout << "*** Score ***" << std::endl;
-            for (auto js = js_all.begin(); js != js_all.end(); js++, index++)
-            {
-                std::cout << index << ". " << js.key() << std::endl;
-                std::cout << "- Easy:" << std::endl;
-                std::cout << "\tScore:" << js.value()["Easy"]["Score"].dump() << std::endl;
-                std::cout << "\tSize:" << js.value()["Easy"]["Size"].dump() << std::endl;
-                std::cout << "- Medium:" << std::endl;
-                std::cout << "\tScore:" << js.value()["Medium"]["Score"].dump() << std::endl;
-                std::cout << "\tSize:" << js.value()["Medium"]["Size"].dump() << std::endl;
-                std::cout << "- Hard:" << std::endl;
-                std::cout << "\tScore:" << js.value()["Hard"]["Score"].dump() << std::endl;
-                std::cout << "\tSize:" << js.value()["Hard"]["Size"].dump() << std::endl;
-            }
-            std::cout << "******" << std::endl;
-            std::cout << "Enter any key to back menu game ..." << std::endl;
-            SysCmm::WaitForAnyKey();
-            SysCmm::ClearTerminal();
+            BrowsePlayers("");
             state_ = MENU_START;
             break;
 
         case 2:
-            js_all = ReadAllJsonFile();
-
-            for (auto js = js_all.begin(); js!= js_all.end(); js++)
+            // Read through the index one page at a time, so only kScanPageSize entries are copied at
+            // once; each level answers from its aggregates.
+            for (std::size_t offset = 0; offset < ListPlayers("", offset, kScanPageSize, players);
+                 offset += kScanPageSize)
             {
-                for (const auto &score : js.value()["Hard"]["Score"])
+                for (const auto &player : players)
                 {
-                    if (score_hard < score)
-                    {
-                        score_hard = score;
-                    }
-                }
-                for (const auto &score : js.value()["Medium"]["Score"])
-                {
-                    if (score_medium < score)
-                    {
-                        score_medium = score;
-                    }
-                }
-                for (const auto &score : js.value()["Easy"]["Score"])
-                {
-                    if (score_easy < score)
-                    {
-                        score_easy = score;
-                    }
+                    score_easy = std::max(score_easy, LevelBest(*player.scores, "Easy"));
+                    score_medium = std::max(score_medium, LevelBest(*player.scores, "Medium"));
+                    score_hard = std::max(score_hard, LevelBest(*player.scores, "Hard"));
                 }
             }
             std::cout << "*** Maximum Score ***" <<  std::endl;
@@ -332,6 +317,11 @@ void MenuChoice::PrintMenuScore(void)
             break;
 
         case 3:
+            FindPlayerMenu();
+            state_ = MENU_START;
+            break;
+
+        case 4:
             state_ = MENU_START;
             break;
 
@@ -341,6 +331,117 @@ void MenuChoice::PrintMenuScore(void)
     }
 }
 
+/**
+ * @brief Prints the recent scores and sizes of one player on every level, and their aggregates.
+ *
+ * @param name The player's name.
+ * @param scores The player's entry in the database.
+ */
+void MenuChoice::PrintPlayer(const std::string &name, const json &scores)
+{
+    std::cout << name << std::endl;
+    for (int level = EASY; level <= HARD; level++)
+    {
+        json const level_scores = scores.value(Parser::LevelToString(level), json::object());
+        std::cout << "- " << Parser::LevelToString(level) << ":" << std::endl;
+        std::cout << "\tScore:" << level_scores.value("Score", json()).dump() << std::endl;
+        std::cout << "\tSize:" << level_scores.value("Size", json()).dump() << std::endl;
+        json const stats = level_scores.value("Stats", json::object());
+        if (stats.value("Count", 0) > 0)
+        {
+            std::cout << "\tGames: " << stats["Count"] << ", Best: " << stats.value("Best", 0)
+                      << ", Mean: " << stats.value("Sum", 0.0) / stats["Count"].get<double>() << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief Lists the players whose names start with a prefix, one page at a time.
+ *
+ * Each page is read from the player index, so paging stays instant however many players the
+ * database holds. The user moves to the next or previous page or goes back to the menu.
+ *
+ * @param prefix The prefix; empty lists every player.
+ */
+void MenuChoice::BrowsePlayers(const std::string &prefix)
+{
+    std::size_t offset = 0;
+    std::vector<PlayerIndex::Entry_t> page;
+    std::string command;
+
+    while (true)
+    {
+        std::size_t const total = ListPlayers(prefix, offset, kPlayersPerPage, page);
+        std::cout << "*** Score ***" << std::endl;
+        if (total == 0)
+        {
+            std::cout << "No players found." << std::endl;
+            std::cout << "******" << std::endl;
+            std::cout << "Enter any key to back menu game ..." << std::endl;
+            SysCmm::WaitForAnyKey();
+            SysCmm::ClearTerminal();
+            return;
+        }
+        for (std::size_t i = 0; i < page.size(); i++)
+        {
+            std::cout << offset + i << ". ";
+            PrintPlayer(*page[i].name, *page[i].scores);
+        }
+        std::cout << "******" << std::endl;
+        std::cout << "Players " << offset << "-" << offset + page.size() - 1 << " of " << total << std::endl;
+        std::cout << "n. Next page, p. Previous page, q. Back to menu" << std::endl;
+        std::cout << "Enter your choice: ";
+
+        std::cin >> command;
+        SysCmm::ClearTerminal();
+        if (command == "n")
+        {
+            if (offset + kPlayersPerPage < total)
+            {
+                offset += kPlayersPerPage;
+            }
+        }
+        else if (command == "p")
+        {
+            offset -= std::min(offset, kPlayersPerPage);
+        }
+        else if (command == "q")
+        {
+            return;
+        }
+        else
+        {
+            PrintChoiceInvalid();
+        }
+    }
+}
+
+/**
+ * @brief Looks up a player by name, or lists the players whose names start with it.
+ *
+ * The exact lookup and the prefix listing both go through the player index.
+ */
+void MenuChoice::FindPlayerMenu(void)
+{
+    std::string query;
+    std::cout << "Enter a player name or the beginning of one: ";
+    std::cin >> query;
+    SysCmm::ClearTerminal();
+
+    const json *scores = FindPlayer(query);
+    if (scores == nullptr)
+    {
+        BrowsePlayers(query);
+        return;
+    }
+    std::cout << "*** Player ***" << std::endl;
+    PrintPlayer(query, *scores);
+    std::cout << "******" << std::endl;
+    std::cout << "Enter any key to back menu game ..." << std::endl;
+    SysCmm::WaitForAnyKey();
+    SysCmm::ClearTerminal();
+}
+
 /**
  * @brief Prints the instructions for the game.
  *
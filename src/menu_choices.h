@@ -35,6 +35,9 @@ class MenuChoice : public ManagerDBJson {
         int GetCurrentLevel(void);
 
     private:
+        static constexpr std::size_t kPlayersPerPage{10};
+        // Players read per call when scanning every player.
+        static constexpr std::size_t kScanPageSize{256};
         MenuState_t state_;
         int level_;
         bool running_;
@@ -45,6 +48,9 @@ class MenuChoice : public ManagerDBJson {
         void PrintMenuGuide(void);
         void PrintMenuPlay(void);
         void SetLevelGame(void);
+        void BrowsePlayers(const std::string &prefix);
+        void FindPlayerMenu(void);
+        void PrintPlayer(const std::string &name, const json &scores);
 };
 
 #endif /* MENU_CHOICES_H */
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "metrics.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+Metrics::Segment *segment = nullptr;
+std::string segment_name;
+
+typedef struct Description {
+  const char *name;
+  const char *help;
+  Metrics::Kind kind;
+} Description_t;
+
+// Indexed by Metrics::Id.
+constexpr Description_t kDescriptions[Metrics::kCount]{
+    {"snake_ticks_total", "Simulation ticks run", Metrics::kCounter},
+    {"snake_frames_total", "Frames rendered", Metrics::kCounter},
+    {"snake_fps", "Frames rendered in the last second", Metrics::kGauge},
+    {"snake_frame_time_p50_ms", "Median frame time over the last second", Metrics::kGauge},
+    {"snake_frame_time_p90_ms", "90th percentile frame time over the last second", Metrics::kGauge},
+    {"snake_frame_time_p99_ms", "99th percentile frame time over the last second", Metrics::kGauge},
+    {"snake_score", "Current score", Metrics::kGauge},
+    {"snake_size", "Current snake size", Metrics::kGauge},
+    {"snake_obstacle_changes_total", "Times the obstacles were regenerated", Metrics::kCounter},
+    {"snake_db_save_latency_ms", "Duration of the last score database save", Metrics::kGauge},
+    {"snake_input_queue_depth", "Turns waiting in the input queue", Metrics::kGauge},
+};
+
+/**
+ * @brief Removes the segments of games that exited without Close(), e.g. because they crashed.
+ *
+ * Segments are named after the pid of their game, so a segment is stale when no process has
+ * that pid anymore.
+ */
+void RemoveStaleSegments(void)
+{
+    std::string const prefix = Metrics::kNamePrefix + 1;  // Without the leading '/'
+    DIR *directory = opendir("/dev/shm");
+    if (directory == nullptr) {
+        return;
+    }
+    while (dirent *entry = readdir(directory)) {
+        if (std::strncmp(entry->d_name, prefix.c_str(), prefix.size()) != 0) {
+            continue;
+        }
+        char *end = nullptr;
+        long const pid = std::strtol(entry->d_name + prefix.size(), &end, 10);
+        if (pid > 0 && *end == '\0' && kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH) {
+            shm_unlink((std::string("/") + entry->d_name).c_str());
+        }
+    }
+    closedir(directory);
+}
+}  // namespace
+
+namespace Metrics {
+
+/**
+ * @brief Creates and describes the shared-memory segment of this process.
+ *
+ * Segments left behind by games that are no longer running are removed first.
+ *
+ * @return True if the segment is ready; otherwise updates stay no-ops.
+ */
+bool Open(void)
+{
+    if (segment != nullptr) {
+        return true;
+    }
+
+    RemoveStaleSegments();
+    segment_name = kNamePrefix + std::to_string(getpid());
+    int fd = shm_open(segment_name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    if (ftruncate(fd, sizeof(Segment)) != 0) {
+        close(fd);
+        shm_unlink(segment_name.c_str());
+        return false;
+    }
+    void *mapping = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        shm_unlink(segment_name.c_str());
+        return false;
+    }
+
+    // The new segment is zero-filled, which is a valid empty value for every slot.
+    Segment *created = static_cast<Segment *>(mapping);
+    created->version = kVersion;
+    created->count = kCount;
+    created->pid = static_cast<std::int32_t>(getpid());
+    for (std::uint32_t i = 0; i < kCount; ++i) {
+        Slot &slot = created->slots[i];
+        slot.kind = kDescriptions[i].kind;
+        std::strncpy(slot.name, kDescriptions[i].name, sizeof(slot.name) - 1);
+        std::strncpy(slot.help, kDescriptions[i].help, sizeof(slot.help) - 1);
+    }
+    created->magic.store(kMagic, std::memory_order_release);
+    segment = created;
+    return true;
+}
+
+/**
+ * @brief Removes the segment. Must only be called once no thread updates metrics anymore.
+ */
+void Close(void)
+{
+    if (segment == nullptr) {
+        return;
+    }
+    munmap(segment, sizeof(Segment));
+    shm_unlink(segment_name.c_str());
+    segment = nullptr;
+}
+
+/**
+ * @brief Adds to a counter.
+ *
+ * @param id The counter.
+ * @param amount The amount to add.
+ */
+void Add(Id id, std::uint64_t amount)
+{
+    if (segment != nullptr) {
+        segment->slots[id].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Sets a gauge.
+ *
+ * @param id The gauge.
+ * @param value The new value.
+ */
+void Set(Id id, double value)
+{
+    if (segment != nullptr) {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        segment->slots[id].value.store(bits, std::memory_order_relaxed);
+    }
+}
+
+}
@@ -0,0 +1,71 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Live counters and gauges published through POSIX shared memory.
+ *
+ * With --metrics the game creates the segment /snake_metrics_<pid> and
+ * updates its values with relaxed atomic stores, so publishing never takes a
+ * lock or makes a system call. SnakeMetrics (tools/metrics_reader.cpp) maps
+ * the segment read-only and prints it in the Prometheus text format. Until
+ * Open() succeeds, every update is a no-op.
+ *
+ * The segment is self-describing: each slot carries its name, help text and
+ * type, and the reader only relies on the layout below.
+ */
+namespace Metrics {
+
+constexpr std::uint32_t kMagic{0x31544D53u};  // "SMT1"
+constexpr std::uint32_t kVersion{1};
+constexpr char kNamePrefix[]{"/snake_metrics_"};
+
+enum Id : std::uint32_t {
+  kTicks,
+  kFrames,
+  kFps,
+  kFrameTimeP50,
+  kFrameTimeP90,
+  kFrameTimeP99,
+  kScore,
+  kSnakeSize,
+  kObstacleChanges,
+  kDbSaveLatency,
+  kInputQueueDepth,
+  kCount
+};
+
+enum Kind : std::uint32_t {
+  kCounter = 1,  // Integer that only grows
+  kGauge = 2     // Double stored as its bit pattern
+};
+
+// One metric per cache line, so threads updating different metrics do not contend.
+struct alignas(64) Slot {
+  std::atomic<std::uint64_t> value;
+  std::uint32_t kind;
+  char name[52];
+  char help[64];
+};
+
+struct Segment {
+  std::atomic<std::uint32_t> magic;  // Written last, once every slot is described
+  std::uint32_t version;
+  std::uint32_t count;
+  std::int32_t pid;
+  Slot slots[kCount];
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Metrics need lock-free 64-bit atomics");
+
+bool Open(void);
+void Close(void);
+void Add(Id id, std::uint64_t amount = 1);
+void Set(Id id, double value);
+
+}  // namespace Metrics
+
+#endif /* METRICS_H */
@@ -0,0 +1,89 @@
+#include "net_protocol.h"
+#include <cstring>
+
+namespace Net {
+
+/**
+ * @brief Applies a snapshot datagram to the client state.
+ *
+ * Snapshots older than the current tick are ignored. Body cells are addressed by absolute index,
+ * so cells the client already holds are skipped and a lost datagram is simply covered by the
+ * next one.
+ *
+ * @param data The datagram.
+ * @param size The datagram size in bytes.
+ *
+ * @return True if the datagram was a valid, newer snapshot.
+ */
+bool SnapshotState::Apply(const std::uint8_t *data, std::size_t size) {
+  SnapshotHeader header;
+  if (size < sizeof(header)) return false;
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != kMagic || header.type != kSnapshot) return false;
+  if (size != sizeof(header) + (header.cell_count + header.obstacle_count) * sizeof(Cell)) return false;
+  if (header.tick <= tick) return false;
+
+  const std::uint8_t *payload = data + sizeof(header);
+  for (std::uint32_t i = 0; i < header.cell_count; ++i) {
+    std::uint64_t index = header.first_index + i;
+    if (index != next_index) continue;
+    Cell cell;
+    std::memcpy(&cell, payload + i * sizeof(Cell), sizeof(Cell));
+    body.push_back(cell);
+    next_index++;
+  }
+  while (tail_index < header.tail_index && !body.empty()) {
+    body.pop_front();
+    tail_index++;
+  }
+  if (body.empty()) {
+    tail_index = header.tail_index;
+    if (next_index < tail_index) next_index = tail_index;
+  }
+  synced = next_index == header.first_index + header.cell_count && header.cell_count < kMaxCellsPerMessage;
+
+  payload += header.cell_count * sizeof(Cell);
+  if (header.obstacle_version != obstacle_version) {
+    obstacles.clear();
+    obstacle_version = header.obstacle_version;
+    obstacle_total = header.obstacle_total;
+  }
+  if (header.obstacle_count > 0 && header.obstacle_offset == obstacles.size()) {
+    for (std::uint32_t i = 0; i < header.obstacle_count; ++i) {
+      Cell cell;
+      std::memcpy(&cell, payload + i * sizeof(Cell), sizeof(Cell));
+      obstacles.push_back(cell);
+    }
+  }
+  obstacles_complete = (obstacles.size() == obstacle_total);
+
+  tick = header.tick;
+  head = header.head;
+  food = header.food;
+  score = header.score;
+  alive = (header.flags & kAlive) != 0;
+  return true;
+}
+
+/**
+ * @brief Builds the input message acknowledging everything received so far.
+ *
+ * @param direction The requested Snake::Direction, or 0xFF to keep the current one.
+ * @param level The level used if the server creates a new game for this client.
+ *
+ * @return The message to send.
+ */
+InputMessage SnapshotState::MakeInput(std::uint8_t direction, std::uint8_t level) const {
+  InputMessage message{};
+  message.magic = kMagic;
+  message.type = kInput;
+  message.direction = direction;
+  message.level = level;
+  message.acked_tick = tick;
+  message.acked_cells = next_index;
+  message.acked_obstacle_version = obstacle_version;
+  message.acked_obstacle_count = static_cast<std::uint32_t>(obstacles.size());
+  return message;
+}
+
+}  // namespace Net
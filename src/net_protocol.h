@@ -0,0 +1,99 @@
+#ifndef NET_PROTOCOL_H
+#define NET_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "cell.h"
+
+/**
+ * @brief Datagram format shared by the tick server and its clients.
+ *
+ * Messages are sent over UDP on localhost in host byte order. A client sends
+ * an InputMessage at least once per tick; it carries the requested direction
+ * and what the client has received so far. The server answers every tick with
+ * a snapshot holding only what the client is missing:
+ * - body cells are numbered by Snake::cells_added, so a snapshot carries the
+ *   new cells after the client's last acknowledged cell plus the index of the
+ *   current tail;
+ * - obstacles are only sent when the acknowledged obstacle version is stale,
+ *   split into chunks if the set does not fit in one datagram.
+ * The head, food and score are always included. Message size therefore depends
+ * on what changed since the last acknowledgement, not on the snake length.
+ */
+namespace Net {
+
+constexpr std::uint16_t kDefaultPort{7777};
+constexpr std::uint32_t kMagic{0x534E4B31u};  // "SNK1"
+constexpr std::size_t kMaxDatagram{60000};
+
+enum MessageType : std::uint8_t {
+  kInput = 1,
+  kSnapshot = 2,
+  kBye = 3
+};
+
+enum SnapshotFlags : std::uint8_t {
+  kAlive = 1 << 0,
+};
+
+struct InputMessage {
+  std::uint32_t magic;
+  std::uint8_t type;
+  std::uint8_t direction;   // Snake::Direction, or 0xFF for no change
+  std::uint8_t level;       // Level of the game created for a new client
+  std::uint8_t reserved;
+  std::uint64_t acked_tick;
+  std::uint64_t acked_cells;              // Next body cell index the client expects
+  std::uint32_t acked_obstacle_version;
+  std::uint32_t acked_obstacle_count;     // Obstacles of that version received so far
+};
+
+struct SnapshotHeader {
+  std::uint32_t magic;
+  std::uint8_t type;
+  std::uint8_t flags;
+  std::uint16_t reserved;
+  std::uint64_t tick;
+  std::uint64_t tail_index;   // Index of the oldest body cell still in the body
+  std::uint64_t first_index;  // Index of the first body cell in this message
+  std::uint32_t cell_count;
+  std::uint32_t obstacle_version;
+  std::uint32_t obstacle_total;
+  std::uint32_t obstacle_offset;
+  std::uint32_t obstacle_count;
+  std::int32_t score;
+  Cell head;
+  Cell food;
+};
+
+constexpr std::size_t kMaxCellsPerMessage{(kMaxDatagram - sizeof(SnapshotHeader)) / sizeof(Cell)};
+
+/**
+ * @brief Client-side copy of one game, rebuilt from snapshots.
+ */
+class SnapshotState {
+ public:
+  bool Apply(const std::uint8_t *data, std::size_t size);
+  InputMessage MakeInput(std::uint8_t direction, std::uint8_t level) const;
+
+  std::uint64_t tick{0};
+  std::uint64_t next_index{0};
+  std::uint64_t tail_index{0};
+  std::deque<Cell> body;
+  // Set when body holds every cell the server had appended at tick.
+  bool synced{false};
+  std::vector<Cell> obstacles;
+  std::uint32_t obstacle_version{0};
+  std::uint32_t obstacle_total{0};
+  bool obstacles_complete{true};
+  Cell head;
+  Cell food;
+  int score{0};
+  bool alive{true};
+};
+
+}  // namespace Net
+
+#endif /* NET_PROTOCOL_H */
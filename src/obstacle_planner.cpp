@@ -0,0 +1,121 @@
+#include "obstacle_planner.h"
+
+namespace {
+// Orthogonal neighbours in clockwise order, then the diagonal between each one and the next.
+constexpr int kOrthogonal[4][2]{{0, -1}, {1, 0}, {0, 1}, {-1, 0}};
+constexpr int kDiagonal[4][2]{{1, -1}, {1, 1}, {-1, 1}, {-1, -1}};
+}  // namespace
+
+/**
+ * @brief Blocks a cell if the free cells stay connected.
+ *
+ * @param cell The cell to block.
+ *
+ * @return True if the cell was blocked (or already was), false if blocking it would cut the board.
+ */
+bool ObstaclePlanner::TryBlock(Cell cell) {
+  if (blocked.Contains(cell)) return true;
+
+  // Free orthogonal neighbours that are linked through a free diagonal form one group; only one
+  // cell per group has to be searched from.
+  bool free[4];
+  for (int i = 0; i < 4; ++i) {
+    Cell neighbour = board.Move(cell, kOrthogonal[i][0], kOrthogonal[i][1]);
+    free[i] = neighbour != cell && !blocked.Contains(neighbour);
+  }
+  bool linked[4];
+  int free_count = 0;
+  int linked_count = 0;
+  for (int i = 0; i < 4; ++i) {
+    Cell diagonal = board.Move(cell, kDiagonal[i][0], kDiagonal[i][1]);
+    linked[i] = free[i] && free[(i + 1) % 4] && !blocked.Contains(diagonal);
+    free_count += free[i];
+    linked_count += linked[i];
+  }
+
+  std::array<Cell, kMaxGroups> starts;
+  int groups = 0;
+  if (free_count - linked_count > 1) {
+    for (int i = 0; i < 4; ++i) {
+      if (free[i] && !linked[(i + 3) % 4]) {
+        starts[groups++] = board.Move(cell, kOrthogonal[i][0], kOrthogonal[i][1]);
+      }
+    }
+  }
+
+  if (groups > 1 && !StaysConnected(cell, starts, groups)) {
+    return false;
+  }
+  blocked.Insert(cell);
+  return true;
+}
+
+/**
+ * @brief Returns the representative of a search group.
+ */
+int ObstaclePlanner::FindGroup(int group) const {
+  while (parent[group] != group) {
+    group = parent[group];
+  }
+  return group;
+}
+
+/**
+ * @brief Checks whether the given cells stay connected once a cell is blocked.
+ *
+ * @param cell The cell about to be blocked.
+ * @param starts One free neighbour of the cell per group.
+ * @param count The number of groups.
+ *
+ * @return True if every start cell can reach every other one.
+ */
+bool ObstaclePlanner::StaysConnected(Cell cell, std::array<Cell, kMaxGroups> const &starts, int count) {
+  int sets = count;
+  for (int g = 0; g < count; ++g) {
+    parent[g] = g;
+    next[g] = 0;
+    visited[g].Clear();
+    frontier[g].clear();
+  }
+  for (int g = 0; g < count; ++g) {
+    for (int other = 0; other < g; ++other) {
+      if (visited[other].Contains(starts[g]) && FindGroup(other) != FindGroup(g)) {
+        parent[FindGroup(g)] = FindGroup(other);
+        sets--;
+      }
+    }
+    visited[g].Insert(starts[g]);
+    frontier[g].push_back(starts[g]);
+  }
+  if (sets == 1) return true;
+
+  while (true) {
+    // Expand every search by one cell.
+    for (int g = 0; g < count; ++g) {
+      if (next[g] == frontier[g].size()) continue;
+      Cell current = frontier[g][next[g]++];
+      for (auto const &step : kOrthogonal) {
+        Cell neighbour = board.Move(current, step[0], step[1]);
+        if (neighbour == cell || blocked.Contains(neighbour) || visited[g].Contains(neighbour)) continue;
+        for (int other = 0; other < count; ++other) {
+          if (other != g && FindGroup(other) != FindGroup(g) && visited[other].Contains(neighbour)) {
+            parent[FindGroup(other)] = FindGroup(g);
+            if (--sets == 1) return true;
+          }
+        }
+        visited[g].Insert(neighbour);
+        frontier[g].push_back(neighbour);
+      }
+    }
+
+    // A set of merged searches with no cells left is a region cut off from the others.
+    for (int root = 0; root < count; ++root) {
+      if (FindGroup(root) != root) continue;
+      bool exhausted = true;
+      for (int g = 0; g < count && exhausted; ++g) {
+        exhausted = FindGroup(g) != root || next[g] == frontier[g].size();
+      }
+      if (exhausted) return false;
+    }
+  }
+}
@@ -0,0 +1,51 @@
+#ifndef OBSTACLE_PLANNER_H
+#define OBSTACLE_PLANNER_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+#include "board.h"
+#include "cell.h"
+#include "cell_hash_set.h"
+
+/**
+ * @brief Builds an obstacle layout one cell at a time without splitting the board.
+ *
+ * A cell is only blocked if the free cells around it stay connected, so the
+ * free part of the board is always one region and the snake can reach the
+ * food and every other free cell. The snake's body counts as free, since it
+ * moves away.
+ *
+ * Most candidates are accepted by looking at their 8 neighbours alone. When
+ * the free neighbours are only linked through the rest of the board, one
+ * breadth-first search per group of neighbours runs in lockstep until all the
+ * searches meet (accept) or one of them runs out of cells (reject), so the
+ * work is bounded by the smallest region that would be cut off. State is kept
+ * in hash sets, so memory does not depend on the board size.
+ */
+class ObstaclePlanner {
+ public:
+  ObstaclePlanner(int grid_width, int grid_height) : board(grid_width, grid_height) {}
+
+  void Reset(void) { blocked.Clear(); }
+  void Reserve(std::size_t count) { blocked.Reserve(count); }
+  bool TryBlock(Cell cell);
+  bool Blocked(Cell cell) const { return blocked.Contains(cell); }
+
+ private:
+  static constexpr int kMaxGroups{4};
+
+  bool StaysConnected(Cell cell, std::array<Cell, kMaxGroups> const &starts, int count);
+  int FindGroup(int group) const;
+
+  Board board;
+  CellHashSet blocked;
+
+  // Search state, kept between calls to reuse its storage.
+  std::array<CellHashSet, kMaxGroups> visited;
+  std::array<std::vector<Cell>, kMaxGroups> frontier;
+  std::array<std::size_t, kMaxGroups> next{};
+  std::array<int, kMaxGroups> parent{};
+};
+
+#endif /* OBSTACLE_PLANNER_H */
@@ -1,4 +1,5 @@
 #include <iostream>
+#include "cell.h"
 #include "parser_string.h"
 
 namespace Parser {
@@ -25,4 +26,138 @@ std::string LevelToString(int level)
     return result;
 }
 
-}
\ No newline at end of file
+/**
+ * @brief Parses a size written as "<width>x<height>", e.g. "1024x768".
+ *
+ * @param text The text to parse.
+ * @param width Receives the width on success.
+ * @param height Receives the height on success.
+ *
+ * @return True if both values are in the range [1, Cell::kMaxGridSide], false otherwise.
+ */
+bool SizeFromString(const std::string &text, std::size_t &width, std::size_t &height)
+{
+    std::size_t separator = text.find('x');
+    if (separator == std::string::npos) {
+        return false;
+    }
+
+    try {
+        unsigned long w = std::stoul(text.substr(0, separator));
+        unsigned long h = std::stoul(text.substr(separator + 1));
+        if (w == 0 || h == 0 || w > Cell::kMaxGridSide || h > Cell::kMaxGridSide) {
+            return false;
+        }
+        width = w;
+        height = h;
+    } catch (const std::exception &) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Fills the game configuration from the command line.
+ *
+ * Supported options:
+ * - --grid <width>x<height>: size of the board in cells.
+ * - --viewport <width>x<height>: number of cells visible on screen, clamped to the board size.
+ * - --arena <snakes>: run the AI arena with the given number of snakes.
+ * - --threads <count>: number of threads used by the arena.
+ * - --server <port>: run the headless tick server on the given UDP port.
+ * - --vsync: present frames in sync with the display refresh.
+ * - --terminal: draw in the terminal instead of an SDL window.
+ * - --metrics: publish live metrics through shared memory.
+ * - --db <file>: score database to use instead of the default one.
+ * - --stats: print score analytics as JSON and exit.
+ * - --pack <file>: play a level from a compiled level pack.
+ * - --pack-level <index>: index of the level in the pack (default 0).
+ * - --export <directory>: record a headless autopilot run as numbered images.
+ * - --export-frames <count>: maximum number of frames to export (default 600).
+ * - --checkpoint <file>: checkpoint the game to a file in the background.
+ * - --resume <file>: resume the game saved in a checkpoint file.
+ * - --rewind-memory <KiB>: keep a rewind history of at most this size.
+ * - --foods <count>: number of foods kept on the board (default 1).
+ * - --power-ups: spawn speed, shrink and ghost power-ups.
+ * - --score-history <games>: raw scores kept per player and level (default 100).
+ *
+ * @param argc The argument count from main.
+ * @param argv The argument vector from main.
+ * @param config The configuration to update.
+ *
+ * @return True if every option was valid, false otherwise.
+ */
+bool ParseCommandLine(int argc, char **argv, GameConfig_t &config)
+{
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        bool has_value = (i + 1 < argc);
+
+        if (option == "--grid" && has_value) {
+            if (!SizeFromString(argv[++i], config.grid_width, config.grid_height)) {
+                std::cerr << "Invalid grid size: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (option == "--viewport" && has_value) {
+            if (!SizeFromString(argv[++i], config.viewport_width, config.viewport_height)) {
+                std::cerr << "Invalid viewport size: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if ((option == "--arena" || option == "--threads" || option == "--pack-level" ||
+                    option == "--export-frames" || option == "--rewind-memory" || option == "--foods" ||
+                    option == "--score-history") &&
+                   has_value) {
+            std::size_t &value = (option == "--arena")           ? config.arena_snakes
+                                 : (option == "--threads")       ? config.threads
+                                 : (option == "--pack-level")    ? config.pack_level
+                                 : (option == "--export-frames") ? config.export_frames
+                                 : (option == "--foods")         ? config.foods
+                                 : (option == "--score-history") ? config.score_history
+                                                                 : config.rewind_kib;
+            try {
+                value = std::stoul(argv[++i]);
+            } catch (const std::exception &) {
+                std::cerr << "Invalid value for " << option << ": " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (option == "--vsync") {
+            config.vsync = true;
+        } else if (option == "--terminal") {
+            config.terminal = true;
+        } else if (option == "--metrics") {
+            config.metrics = true;
+        } else if (option == "--power-ups") {
+            config.power_ups = true;
+        } else if (option == "--stats") {
+            config.stats = true;
+        } else if (option == "--db" && has_value) {
+            config.db_path = argv[++i];
+        } else if (option == "--pack" && has_value) {
+            config.level_pack = argv[++i];
+        } else if (option == "--export" && has_value) {
+            config.export_directory = argv[++i];
+        } else if (option == "--checkpoint" && has_value) {
+            config.checkpoint_path = argv[++i];
+        } else if (option == "--resume" && has_value) {
+            config.resume_path = argv[++i];
+        } else if (option == "--server" && has_value) {
+            try {
+                config.server_port = static_cast<unsigned>(std::stoul(argv[++i]));
+            } catch (const std::exception &) {
+                config.server_port = 0;
+            }
+            if (config.server_port == 0 || config.server_port > 65535) {
+                std::cerr << "Invalid server port: " << argv[i] << std::endl;
+                return false;
+            }
+        } else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
@@ -1,10 +1,14 @@
 #ifndef PARSER_STRING_H
 #define PARSER_STRING_H
 
+#include <cstddef>
 #include <string>
+#include "game_config.h"
 
 namespace Parser {
     std::string LevelToString(int level);
+    bool SizeFromString(const std::string &text, std::size_t &width, std::size_t &height);
+    bool ParseCommandLine(int argc, char **argv, GameConfig_t &config);
 }
 
 #endif /* PARSER_STRING_H */
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "player_index.h"
+#include <algorithm>
+
+namespace {
+bool NameLess(PlayerIndex::Entry_t const &entry, std::string const &name) { return *entry.name < name; }
+}  // namespace
+
+/**
+ * @brief Replaces the index with the players of a database.
+ *
+ * JSON objects iterate in name order, so building is one linear pass without sorting.
+ *
+ * @param players The database object, player name -> scores; anything else gives an empty index.
+ */
+void PlayerIndex::Build(nlohmann::json const &players) {
+  entries.clear();
+  if (!players.is_object()) return;
+  entries.reserve(players.size());
+  for (auto it = players.begin(); it != players.end(); ++it) {
+    entries.push_back(Entry_t{&it.key(), &it.value()});
+  }
+}
+
+/**
+ * @brief Adds a player, or points an indexed player at new scores.
+ *
+ * @param name The player's name, as stored in the database object.
+ * @param scores The player's scores, as stored in the database object.
+ */
+void PlayerIndex::Insert(std::string const &name, nlohmann::json const &scores) {
+  auto it = std::lower_bound(entries.begin(), entries.end(), name, NameLess);
+  if (it != entries.end() && *it->name == name) {
+    *it = Entry_t{&name, &scores};
+  } else {
+    entries.insert(it, Entry_t{&name, &scores});
+  }
+}
+
+/**
+ * @brief Looks up a player by exact name.
+ *
+ * @param name The name.
+ *
+ * @return The player's scores, or nullptr if there is no such player.
+ */
+const nlohmann::json *PlayerIndex::Find(std::string const &name) const {
+  auto it = std::lower_bound(entries.begin(), entries.end(), name, NameLess);
+  return (it != entries.end() && *it->name == name) ? it->scores : nullptr;
+}
+
+/**
+ * @brief Returns the range of entries whose names start with a prefix.
+ *
+ * @param prefix The prefix; empty matches every player.
+ *
+ * @return The first entry and one past the last entry of the range.
+ */
+std::pair<std::size_t, std::size_t> PlayerIndex::PrefixRange(std::string const &prefix) const {
+  auto first = std::lower_bound(entries.begin(), entries.end(), prefix, NameLess);
+  auto last = std::partition_point(first, entries.end(), [&prefix](Entry_t const &entry) {
+    return entry.name->compare(0, prefix.size(), prefix) == 0;
+  });
+  return {static_cast<std::size_t>(first - entries.begin()), static_cast<std::size_t>(last - entries.begin())};
+}
+
+/**
+ * @brief Lists one page of the players whose names start with a prefix, in name order.
+ *
+ * @param prefix The prefix; empty lists every player.
+ * @param offset The number of matching players to skip.
+ * @param limit The largest number of players to list.
+ * @param page Receives the players; valid until the database changes.
+ *
+ * @return The number of players matching the prefix.
+ */
+std::size_t PlayerIndex::Page(std::string const &prefix, std::size_t offset, std::size_t limit,
+                              std::vector<Entry_t> &page) const {
+  auto const range = PrefixRange(prefix);
+  std::size_t const matches = range.second - range.first;
+  std::size_t const first = range.first + std::min(offset, matches);
+  std::size_t const last = first + std::min(limit, range.second - first);
+  page.assign(entries.begin() + first, entries.begin() + last);
+  return matches;
+}
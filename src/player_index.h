@@ -0,0 +1,42 @@
+#ifndef PLAYER_INDEX_H
+#define PLAYER_INDEX_H
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief Sorted index over the players of the score database.
+ *
+ * Each entry points at the name and the scores of one player inside the
+ * database's JSON object, whose entries keep their address while other
+ * players are added, so the index copies no names. Entries are sorted by
+ * name, so the players starting with a prefix are one contiguous range:
+ * exact lookup and finding a prefix's range are binary searches, and a page
+ * of k players is a slice of that range, O(log n + k) whatever the number of
+ * players. Adding a player shifts the entries after it, one memmove of 16
+ * bytes per player.
+ */
+class PlayerIndex {
+ public:
+  typedef struct Entry {
+    const std::string *name;
+    const nlohmann::json *scores;
+  } Entry_t;
+
+  void Build(nlohmann::json const &players);
+  void Insert(std::string const &name, nlohmann::json const &scores);
+  const nlohmann::json *Find(std::string const &name) const;
+  std::size_t Page(std::string const &prefix, std::size_t offset, std::size_t limit,
+                   std::vector<Entry_t> &page) const;
+  std::size_t Size(void) const { return entries.size(); }
+
+ private:
+  std::vector<Entry_t> entries;  // Sorted by name
+
+  std::pair<std::size_t, std::size_t> PrefixRange(std::string const &prefix) const;
+};
+
+#endif /* PLAYER_INDEX_H */
@@ -1,23 +1,64 @@
 #include "renderer.h"
+#include "arena.h"
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
-#include <string>
+
+namespace {
+// Colors of the SDL backend; the terminal backend uses the nearest 256-color entries.
+constexpr SDL_Color kBackgroundColor{0x1E, 0x1E, 0x1E, 0xFF};
+constexpr SDL_Color kFoodColor{0xFF, 0xCC, 0x00, 0xFF};
+constexpr SDL_Color kObstacleColor{0xA9, 0xA9, 0xA9, 0xFF};
+constexpr SDL_Color kBodyColor{0xFF, 0xFF, 0xFF, 0xFF};
+constexpr SDL_Color kHeadColor{0x00, 0x7A, 0xCC, 0xFF};
+constexpr SDL_Color kDeadHeadColor{0xFF, 0x00, 0x00, 0xFF};
+// Colors and terminal glyphs of each ItemKind.
+constexpr SDL_Color kItemColors[kItemKinds]{
+    kFoodColor, {0x00, 0xE5, 0xFF, 0xFF}, {0xFF, 0x3E, 0xD0, 0xFF}, {0xB3, 0x9D, 0xDB, 0xFF}};
+constexpr TerminalScreen::Glyph kItemGlyphs[kItemKinds]{TerminalScreen::kFood, TerminalScreen::kSpeed,
+                                                        TerminalScreen::kShrink, TerminalScreen::kGhost};
+constexpr std::size_t kFood{static_cast<std::size_t>(ItemKind::kFood)};
+}  // namespace
 
 Renderer::Renderer(const std::size_t screen_width, const std::size_t screen_height,
-                   const std::size_t grid_width, const std::size_t grid_height)
+                   const std::size_t grid_width, const std::size_t grid_height,
+                   const std::size_t viewport_width, const std::size_t viewport_height,
+                   bool vsync, Backend backend)
     : screen_width(screen_width),
       screen_height(screen_height),
       grid_width(grid_width),
-      grid_height(grid_height) {
+      grid_height(grid_height),
+      viewport_width(std::min(viewport_width, grid_width)),
+      viewport_height(std::min(viewport_height, grid_height)),
+      vsync(vsync && backend == Backend::kWindow) {
+  // At most every visible tile is drawn in one batch.
+  visible_blocks.reserve(this->viewport_width * this->viewport_height);
+  visible_heads.reserve(this->viewport_width * this->viewport_height);
+  for (std::vector<SDL_Rect> &blocks : visible_items) {
+    blocks.reserve(this->viewport_width * this->viewport_height);
+  }
+
+  // The terminal backend only needs SDL's timers; nothing is drawn before Show() so that the
+  // menu can still use the terminal.
+  if (backend == Backend::kTerminal) {
+    if (SDL_Init(SDL_INIT_TIMER) < 0) {
+      std::cerr << "SDL could not initialize.\n";
+      std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
+    }
+    terminal = std::make_unique<TerminalScreen>(this->viewport_width, this->viewport_height);
+    return;
+  }
+
   // Initialize SDL
   if (SDL_Init(SDL_INIT_VIDEO) < 0) {
     std::cerr << "SDL could not initialize.\n";
     std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
   }
 
-  // Create Window
+  // Create Window, hidden until Show() so that it can be prepared while the menu is open
   sdl_window = SDL_CreateWindow("Snake Game", SDL_WINDOWPOS_CENTERED,
                                 SDL_WINDOWPOS_CENTERED, screen_width,
-                                screen_height, SDL_WINDOW_SHOWN);
+                                screen_height, SDL_WINDOW_HIDDEN);
 
   if (nullptr == sdl_window) {
     std::cerr << "Window could not be created.\n";
@@ -25,7 +66,11 @@ Renderer::Renderer(const std::size_t screen_width, const std::size_t screen_heig
   }
 
   // Create renderer
-  sdl_renderer = SDL_CreateRenderer(sdl_window, -1, SDL_RENDERER_ACCELERATED);
+  Uint32 renderer_flags = SDL_RENDERER_ACCELERATED;
+  if (vsync) {
+    renderer_flags |= SDL_RENDERER_PRESENTVSYNC;
+  }
+  sdl_renderer = SDL_CreateRenderer(sdl_window, -1, renderer_flags);
   if (nullptr == sdl_renderer) {
     std::cerr << "Renderer could not be created.\n";
     std::cerr << "SDL_Error: " << SDL_GetError() << "\n";
@@ -33,56 +78,268 @@ Renderer::Renderer(const std::size_t screen_width, const std::size_t screen_heig
 }
 
 Renderer::~Renderer() {
-  SDL_DestroyWindow(sdl_window);
+  // Restores the terminal before SDL shuts down.
+  terminal.reset();
+  if (sdl_window != nullptr) {
+    SDL_DestroyWindow(sdl_window);
+  }
   SDL_Quit();
 }
 
-void Renderer::Render(Snake const snake, SDL_Point const &food, std::vector<SDL_Point> const &obstacles) {
-  SDL_Rect block;
-  block.w = screen_width / grid_width;
-  block.h = screen_height / grid_height;
+/**
+ * @brief Moves the camera so that the head stays in the middle of the viewport.
+ *
+ * When the viewport covers the whole board on an axis the camera is fixed at 0 on that axis,
+ * otherwise it follows the head and wraps around the board like the snake does.
+ *
+ * @param head The cell of the snake's head.
+ */
+void Renderer::UpdateCamera(Cell const &head) {
+  int const grid_w = static_cast<int>(grid_width);
+  int const grid_h = static_cast<int>(grid_height);
+  int const view_w = static_cast<int>(viewport_width);
+  int const view_h = static_cast<int>(viewport_height);
+
+  camera_x = (view_w < grid_w) ? (head.x - view_w / 2 + grid_w) % grid_w : 0;
+  camera_y = (view_h < grid_h) ? (head.y - view_h / 2 + grid_h) % grid_h : 0;
+}
+
+/**
+ * @brief Converts a grid cell into its on-screen block.
+ *
+ * @param cell The grid cell to convert.
+ * @param block The block to update; only its position is written.
+ *
+ * @return True if the cell is inside the viewport, false if it must be culled.
+ */
+bool Renderer::ToScreen(Cell const &cell, SDL_Rect &block) const {
+  int const view_x = (cell.x - camera_x + static_cast<int>(grid_width)) % static_cast<int>(grid_width);
+  int const view_y = (cell.y - camera_y + static_cast<int>(grid_height)) % static_cast<int>(grid_height);
+  if (view_x >= static_cast<int>(viewport_width) || view_y >= static_cast<int>(viewport_height)) {
+    return false;
+  }
+  block.x = view_x * block.w;
+  block.y = view_y * block.h;
+  return true;
+}
+
+/**
+ * @brief Returns a block holding the size of one tile.
+ *
+ * Terminal tiles are one character cell, so blocks hold viewport coordinates.
+ */
+SDL_Rect Renderer::BlockSize(void) const {
+  SDL_Rect block{0, 0, 1, 1};
+  if (!terminal) {
+    block.w = static_cast<int>(screen_width / viewport_width);
+    block.h = static_cast<int>(screen_height / viewport_height);
+  }
+  return block;
+}
+
+/**
+ * @brief Collects the blocks of every visible cell of a list into visible_blocks.
+ *
+ * @param cells The cells to collect; cells outside the viewport are culled.
+ * @param block A block holding the tile size.
+ */
+void Renderer::CollectCells(std::vector<Cell> const &cells, SDL_Rect const &block) {
+  visible_blocks.clear();
+  SDL_Rect rect = block;
+  for (Cell const &cell : cells) {
+    if (ToScreen(cell, rect)) {
+      visible_blocks.push_back(rect);
+    }
+  }
+}
+
+/**
+ * @brief Collects the blocks of the visible cells of a set into visible_blocks.
+ *
+ * When the set holds more cells than the viewport has tiles, the visible tiles are probed in the
+ * set instead, so the work stays proportional to the visible area on dense boards.
+ *
+ * @param cells The cells to collect.
+ * @param block A block holding the tile size.
+ */
+void Renderer::CollectCells(CellHashSet const &cells, SDL_Rect const &block) {
+  if (cells.Size() <= viewport_width * viewport_height) {
+    CollectCells(cells.Cells(), block);
+    return;
+  }
+
+  visible_blocks.clear();
+  SDL_Rect rect = block;
+  for (std::size_t view_y = 0; view_y < viewport_height; ++view_y) {
+    int const y = static_cast<int>((camera_y + view_y) % grid_height);
+    for (std::size_t view_x = 0; view_x < viewport_width; ++view_x) {
+      int const x = static_cast<int>((camera_x + view_x) % grid_width);
+      if (cells.Contains(Cell(x, y))) {
+        rect.x = static_cast<int>(view_x) * rect.w;
+        rect.y = static_cast<int>(view_y) * rect.h;
+        visible_blocks.push_back(rect);
+      }
+    }
+  }
+}
 
-  // Clear screen
-  SDL_SetRenderDrawColor(sdl_renderer, 0x1E, 0x1E, 0x1E, 0xFF);
+/**
+ * @brief Starts a frame: clears the window or the terminal frame.
+ */
+void Renderer::BeginFrame(void) {
+  if (terminal) {
+    terminal->Clear();
+    return;
+  }
+  SDL_SetRenderDrawColor(sdl_renderer, kBackgroundColor.r, kBackgroundColor.g, kBackgroundColor.b, kBackgroundColor.a);
   SDL_RenderClear(sdl_renderer);
+}
+
+/**
+ * @brief Draws blocks in one batch.
+ *
+ * @param blocks The blocks to draw.
+ * @param color The color of the blocks in the window.
+ * @param glyph The glyph of the blocks in the terminal.
+ */
+void Renderer::DrawBlocks(std::vector<SDL_Rect> const &blocks, SDL_Color const &color, TerminalScreen::Glyph glyph) {
+  if (terminal) {
+    for (SDL_Rect const &block : blocks) {
+      terminal->Set(block.x, block.y, glyph);
+    }
+    return;
+  }
+  if (!blocks.empty()) {
+    SDL_SetRenderDrawColor(sdl_renderer, color.r, color.g, color.b, color.a);
+    SDL_RenderFillRects(sdl_renderer, blocks.data(), static_cast<int>(blocks.size()));
+  }
+}
 
-  // Render food
-  SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0xCC, 0x00, 0xFF);
-  block.x = food.x * block.w;
-  block.y = food.y * block.h;
-  SDL_RenderFillRect(sdl_renderer, &block);
+/**
+ * @brief Ends a frame: presents the window, or writes the changed cells to the terminal.
+ */
+void Renderer::EndFrame(void) {
+  if (terminal) {
+    terminal->Present();
+    return;
+  }
+  SDL_RenderPresent(sdl_renderer);
+}
 
-  // Render obstacles
-  SDL_SetRenderDrawColor(sdl_renderer, 0xA9, 0xA9, 0xA9, 0xFF); // Gray color for obstacles
-  for (auto const &obstacle : obstacles) {
-    block.x = obstacle.x * block.w;
-    block.y = obstacle.y * block.h;
-    SDL_RenderFillRect(sdl_renderer, &block);
+/**
+ * @brief Renders one simulation snapshot.
+ *
+ * @param frame The snapshot to draw; it is only read, so it can be shared with the simulation thread.
+ */
+void Renderer::Render(FrameSnapshot_t const &frame) {
+  SDL_Rect block = BlockSize();
+
+  UpdateCamera(frame.head);
+  BeginFrame();
+
+  // Render foods and power-ups, one batch per kind
+  for (std::vector<SDL_Rect> &blocks : visible_items) {
+    blocks.clear();
   }
+  for (Item_t const &item : frame.items) {
+    if (ToScreen(item.cell, block)) {
+      visible_items[static_cast<std::size_t>(item.kind)].push_back(block);
+    }
+  }
+  for (std::size_t kind = 0; kind < kItemKinds; ++kind) {
+    DrawBlocks(visible_items[kind], kItemColors[kind], kItemGlyphs[kind]);
+  }
+
+  // Render obstacles
+  CollectCells(frame.obstacles, block);
+  DrawBlocks(visible_blocks, kObstacleColor, TerminalScreen::kObstacle);
 
-  // Render snake's body
-  SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-  for (SDL_Point const &point : snake.body) {
-    block.x = point.x * block.w;
-    block.y = point.y * block.h;
-    SDL_RenderFillRect(sdl_renderer, &block);
+  // Render snake's body, probing the viewport when the snapshot indexed a long body
+  if (frame.body_cells.Empty()) {
+    CollectCells(frame.body, block);
+  } else {
+    CollectCells(frame.body_cells, block);
   }
+  DrawBlocks(visible_blocks, kBodyColor, TerminalScreen::kBody);
 
   // Render snake's head
-  block.x = static_cast<int>(snake.head_x) * block.w;
-  block.y = static_cast<int>(snake.head_y) * block.h;
-  if (snake.alive) {
-    SDL_SetRenderDrawColor(sdl_renderer, 0x00, 0x7A, 0xCC, 0xFF);
+  visible_heads.clear();
+  ToScreen(frame.head, block);
+  visible_heads.push_back(block);
+  if (frame.alive) {
+    DrawBlocks(visible_heads, kHeadColor, TerminalScreen::kHead);
   } else {
-    SDL_SetRenderDrawColor(sdl_renderer, 0xFF, 0x00, 0x00, 0xFF);
+    DrawBlocks(visible_heads, kDeadHeadColor, TerminalScreen::kDeadHead);
   }
-  SDL_RenderFillRect(sdl_renderer, &block);
 
   // Update Screen
-  SDL_RenderPresent(sdl_renderer);
+  EndFrame();
+}
+
+/**
+ * @brief Renders the visible part of an arena.
+ *
+ * The camera follows the arena's focus snake and only the tiles inside the viewport are read from
+ * the arena's occupancy grid, so the cost does not depend on the number of snakes.
+ *
+ * @param arena The arena to render.
+ */
+void Renderer::RenderArena(Arena const &arena) {
+  SDL_Rect block = BlockSize();
+
+  UpdateCamera(arena.FocusCell());
+
+  visible_blocks.clear();
+  visible_heads.clear();
+  visible_items[kFood].clear();
+  for (std::size_t view_y = 0; view_y < viewport_height; ++view_y) {
+    int const y = static_cast<int>((camera_y + view_y) % grid_height);
+    for (std::size_t view_x = 0; view_x < viewport_width; ++view_x) {
+      int const x = static_cast<int>((camera_x + view_x) % grid_width);
+      std::uint32_t occupant = arena.OccupantAt(Cell(x, y));
+      if (occupant == Arena::kFree) continue;
+
+      block.x = static_cast<int>(view_x) * block.w;
+      block.y = static_cast<int>(view_y) * block.h;
+      if (occupant & Arena::kFoodFlag) {
+        visible_items[kFood].push_back(block);
+      } else if (arena.IsHead(Cell(x, y))) {
+        visible_heads.push_back(block);
+      } else {
+        visible_blocks.push_back(block);
+      }
+    }
+  }
+
+  // Render food, bodies and heads
+  BeginFrame();
+  DrawBlocks(visible_items[kFood], kFoodColor, TerminalScreen::kFood);
+  DrawBlocks(visible_blocks, kBodyColor, TerminalScreen::kBody);
+  DrawBlocks(visible_heads, kHeadColor, TerminalScreen::kHead);
+
+  // Update Screen
+  EndFrame();
+}
+
+void Renderer::Show(void) {
+  if (terminal) {
+    terminal->Open();
+    return;
+  }
+  SDL_ShowWindow(sdl_window);
 }
 
-void Renderer::UpdateWindowTitle(int score, int fps) {
-  std::string title{"Snake Score: " + std::to_string(score) + " FPS: " + std::to_string(fps)};
-  SDL_SetWindowTitle(sdl_window, title.c_str());
+void Renderer::UpdateWindowTitle(int score, int fps, const char *state) {
+  if (terminal) {
+    terminal->SetStatus(score, fps, state);
+    return;
+  }
+  // Formatted into a fixed buffer so that the frame loop does not allocate.
+  char title[64];
+  if (state != nullptr) {
+    std::snprintf(title, sizeof(title), "Snake Score: %d FPS: %d - %s", score, fps, state);
+  } else {
+    std::snprintf(title, sizeof(title), "Snake Score: %d FPS: %d", score, fps);
+  }
+  SDL_SetWindowTitle(sdl_window, title);
 }
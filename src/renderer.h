@@ -1,27 +1,65 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <array>
+#include <memory>
 #include <vector>
 #include "SDL.h"
-#include "snake.h"
+#include "cell.h"
+#include "cell_hash_set.h"
+#include "frame_snapshot.h"
+#include "item_board.h"
+#include "terminal_screen.h"
+
+class Arena;
 
 class Renderer {
  public:
+  // Draw in an SDL window, or in the terminal with ANSI escape codes.
+  enum class Backend { kWindow, kTerminal };
+
   Renderer(const std::size_t screen_width, const std::size_t screen_height,
-           const std::size_t grid_width, const std::size_t grid_height);
+           const std::size_t grid_width, const std::size_t grid_height,
+           const std::size_t viewport_width, const std::size_t viewport_height,
+           bool vsync = false, Backend backend = Backend::kWindow);
   ~Renderer();
 
-  void Render(Snake const snake, SDL_Point const &food, std::vector<SDL_Point> const &obstacles);
-  void UpdateWindowTitle(int score, int fps);
+  void Render(FrameSnapshot_t const &frame);
+  void RenderArena(Arena const &arena);
+  void UpdateWindowTitle(int score, int fps, const char *state = nullptr);
+  void Show(void);
+  bool HasVsync(void) const { return vsync; }
 
  private:
-  SDL_Window *sdl_window;
-  SDL_Renderer *sdl_renderer;
+  SDL_Window *sdl_window{nullptr};
+  SDL_Renderer *sdl_renderer{nullptr};
+  // Set for the terminal backend, which has no window.
+  std::unique_ptr<TerminalScreen> terminal;
 
   const std::size_t screen_width;
   const std::size_t screen_height;
   const std::size_t grid_width;
   const std::size_t grid_height;
+  const std::size_t viewport_width;
+  const std::size_t viewport_height;
+  bool vsync;
+
+  // Top-left cell of the camera, updated each frame to follow the head.
+  int camera_x{0};
+  int camera_y{0};
+  std::vector<SDL_Rect> visible_blocks;
+  std::vector<SDL_Rect> visible_heads;
+  // Visible items of each ItemKind.
+  std::array<std::vector<SDL_Rect>, kItemKinds> visible_items;
+
+  void UpdateCamera(Cell const &head);
+  bool ToScreen(Cell const &cell, SDL_Rect &block) const;
+  SDL_Rect BlockSize(void) const;
+  void CollectCells(std::vector<Cell> const &cells, SDL_Rect const &block);
+  void CollectCells(CellHashSet const &cells, SDL_Rect const &block);
+  void BeginFrame(void);
+  void DrawBlocks(std::vector<SDL_Rect> const &blocks, SDL_Color const &color, TerminalScreen::Glyph glyph);
+  void EndFrame(void);
 };
 
 #endif
@@ -0,0 +1,156 @@
+#include "rewind_buffer.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+/**
+ * @brief Creates an empty history.
+ *
+ * @param capacity The memory the history may use, in bytes; all of it is allocated up front.
+ */
+RewindBuffer::RewindBuffer(std::size_t capacity) : ring(std::max<std::size_t>(capacity, sizeof(EntryHeader_t))) {}
+
+/**
+ * @brief Stores one tick and takes its changes out of the delta.
+ *
+ * @param delta The changes captured from the game since the previous tick; when the history is
+ *              empty, they must hold the whole state, as a fresh capture does.
+ */
+void RewindBuffer::Record(CheckpointDelta_t &delta) {
+  CheckpointRecord::EncodeDelta(record, delta);
+  delta.new_cells.clear();
+  delta.obstacles_changed = false;
+  delta.items_changed = false;
+  delta.engine_changed = false;
+
+  std::size_t record_size;
+  bool full;
+  if (!current.Apply(record.data(), record.size(), record_size, full)) return;
+
+  std::uint64_t const tick = delta.scalars.tick;
+  bool keyframe = Empty() || tick >= keyframe_tick + kKeyframeTicks;
+  if (keyframe) {
+    current.EncodeFull(record);
+  }
+  MakeRoom(sizeof(EntryHeader_t) + record.size());
+  if (!keyframe && Empty()) {
+    // The keyframe this delta depended on was dropped to make room.
+    current.EncodeFull(record);
+    keyframe = true;
+    MakeRoom(sizeof(EntryHeader_t) + record.size());
+  }
+  std::size_t const size = sizeof(EntryHeader_t) + record.size();
+  if (size > ring.size()) return;  // A keyframe larger than the whole history is not kept
+
+  EntryHeader_t header{tick, newest, static_cast<std::uint32_t>(size), keyframe ? 1u : 0u};
+  Write(end, &header, sizeof(header));
+  Write(end + sizeof(header), record.data(), record.size());
+  newest = end;
+  end += size;
+  if (keyframe) {
+    keyframe_tick = tick;
+  }
+}
+
+/**
+ * @brief Restores the state of a past tick and forgets the ticks after it.
+ *
+ * @param tick The tick to restore; must be between OldestTick() and NewestTick().
+ * @param state Receives the state.
+ *
+ * @return False if the tick is no longer, or not yet, in the history.
+ */
+bool RewindBuffer::Seek(std::uint64_t tick, GameState_t &state) {
+  if (Empty() || tick < OldestTick() || tick > NewestTick()) return false;
+
+  // Walk back to the nearest keyframe at or before the tick.
+  std::uint64_t position = newest;
+  EntryHeader_t header = Header(position);
+  while (!header.keyframe || header.tick > tick) {
+    if (header.previous == kNone || header.previous < begin) return false;
+    position = header.previous;
+    header = Header(position);
+  }
+
+  // Replay it and the deltas up to the tick.
+  CheckpointState restored;
+  std::uint64_t last = position;
+  std::uint64_t const keyframe = header.tick;
+  while (position != end) {
+    header = Header(position);
+    if (header.tick > tick) break;
+    record.resize(header.size - sizeof(EntryHeader_t));
+    Read(position + sizeof(EntryHeader_t), record.data(), record.size());
+    std::size_t record_size;
+    bool full;
+    restored.Apply(record.data(), record.size(), record_size, full);
+    last = position;
+    position += header.size;
+  }
+
+  current = std::move(restored);
+  current.Get(state);
+  newest = last;
+  end = last + Header(last).size;
+  keyframe_tick = keyframe;
+  return true;
+}
+
+/**
+ * @brief Returns the oldest tick in the history; the history must not be empty.
+ */
+std::uint64_t RewindBuffer::OldestTick(void) const {
+  return Header(begin).tick;
+}
+
+/**
+ * @brief Returns the newest tick in the history; the history must not be empty.
+ */
+std::uint64_t RewindBuffer::NewestTick(void) const {
+  return Header(newest).tick;
+}
+
+/**
+ * @brief Reads the header of the entry at a position.
+ */
+RewindBuffer::EntryHeader_t RewindBuffer::Header(std::uint64_t position) const {
+  EntryHeader_t header;
+  Read(position, &header, sizeof(header));
+  return header;
+}
+
+/**
+ * @brief Copies bytes out of the ring, wrapping around its end.
+ */
+void RewindBuffer::Read(std::uint64_t position, void *data, std::size_t size) const {
+  std::size_t const offset = position % ring.size();
+  std::size_t const first = std::min(size, ring.size() - offset);
+  std::memcpy(data, ring.data() + offset, first);
+  std::memcpy(static_cast<std::uint8_t *>(data) + first, ring.data(), size - first);
+}
+
+/**
+ * @brief Copies bytes into the ring, wrapping around its end.
+ */
+void RewindBuffer::Write(std::uint64_t position, const void *data, std::size_t size) {
+  std::size_t const offset = position % ring.size();
+  std::size_t const first = std::min(size, ring.size() - offset);
+  std::memcpy(ring.data() + offset, data, first);
+  std::memcpy(ring.data(), static_cast<const std::uint8_t *>(data) + first, size - first);
+}
+
+/**
+ * @brief Drops the oldest keyframes, each with its deltas, until an entry of the given size fits.
+ *
+ * @param size The size of the entry to store.
+ */
+void RewindBuffer::MakeRoom(std::size_t size) {
+  while (!Empty() && end - begin + size > ring.size()) {
+    do {
+      begin += Header(begin).size;
+    } while (begin != end && !Header(begin).keyframe);
+    if (begin == end) {
+      newest = kNone;
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef REWIND_BUFFER_H
+#define REWIND_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "checkpoint.h"
+
+/**
+ * @brief Memory-bounded history of a game's ticks, for rewinding.
+ *
+ * Ticks are stored in a fixed-size byte ring as checkpoint delta records:
+ * the scalars, the body cells added and the tail index, and the obstacles,
+ * items or RNG engine only when they changed, so a tick costs about 120 bytes
+ * whatever the snake's length. Every kKeyframeTicks ticks a full record (a
+ * keyframe) is stored instead. When the ring is full the oldest keyframe is
+ * dropped together with its deltas, so the history always starts with a
+ * keyframe. Seeking restores the nearest keyframe at or before the target
+ * and replays at most kKeyframeTicks deltas.
+ */
+class RewindBuffer {
+ public:
+  static constexpr std::uint64_t kKeyframeTicks{120};
+
+  explicit RewindBuffer(std::size_t capacity);
+
+  void Record(CheckpointDelta_t &delta);
+  bool Seek(std::uint64_t tick, GameState_t &state);
+  bool Empty(void) const { return newest == kNone; }
+  std::uint64_t OldestTick(void) const;
+  std::uint64_t NewestTick(void) const;
+
+ private:
+  static constexpr std::uint64_t kNone{~0ull};
+
+  // Precedes every record in the ring.
+  typedef struct EntryHeader {
+    std::uint64_t tick;
+    std::uint64_t previous;  // Position of the previous entry, or kNone
+    std::uint32_t size;      // Header and record
+    std::uint32_t keyframe;
+  } EntryHeader_t;
+
+  // Positions grow without bound; the byte at position p is ring[p % ring.size()].
+  std::vector<std::uint8_t> ring;
+  std::uint64_t begin{0};       // Oldest entry, always a keyframe
+  std::uint64_t end{0};         // Just after the newest entry
+  std::uint64_t newest{kNone};  // Newest entry
+  std::uint64_t keyframe_tick{0};
+
+  // State at the newest entry, from which keyframes are encoded.
+  CheckpointState current;
+  std::vector<std::uint8_t> record;
+
+  EntryHeader_t Header(std::uint64_t position) const;
+  void Read(std::uint64_t position, void *data, std::size_t size) const;
+  void Write(std::uint64_t position, const void *data, std::size_t size);
+  void MakeRoom(std::size_t size);
+};
+
+#endif /* REWIND_BUFFER_H */
@@ -0,0 +1,378 @@
+#include "score_analytics.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <nlohmann/json.hpp>
+#include "parser_string.h"
+
+using json = nlohmann::json;
+
+namespace {
+/**
+ * @brief SAX handler that hands every player of the score database to ScoreAnalytics.
+ *
+ * The database maps player name -> level name -> {"Score": [...], "Size": [...], "Older": [...]},
+ * where "Older" holds the downsampled buckets of games dropped from "Score"; only the scores of
+ * known levels are kept. Scores above kMaxScore can not come from a real board and are skipped,
+ * so a corrupt entry can not blow up the score counts.
+ */
+class ScoreSax : public nlohmann::json_sax<json> {
+ public:
+  explicit ScoreSax(ScoreAnalytics &analytics) : analytics(analytics) {}
+
+  bool null() override { return true; }
+  bool boolean(bool) override { return true; }
+  bool number_integer(number_integer_t value) override { return Number(static_cast<double>(value)); }
+  bool number_unsigned(number_unsigned_t value) override { return Number(static_cast<double>(value)); }
+  bool number_float(number_float_t value, const string_t &) override { return Number(value); }
+  bool string(string_t &) override { return true; }
+  bool binary(binary_t &) override { return true; }
+
+  bool start_object(std::size_t) override {
+    depth++;
+    if (depth == 5 && in_older) {
+      bucket_field = nullptr;
+      in_bucket = true;
+    }
+    return true;
+  }
+
+  bool key(string_t &value) override {
+    if (depth == 1) {
+      player = &analytics.NextPlayer();
+      player->name = value;
+    } else if (depth == 2) {
+      level = -1;
+      for (int i = 0; i < static_cast<int>(ScoreAnalytics::kLevelCount); ++i) {
+        if (value == Parser::LevelToString(i + 1)) level = i;
+      }
+    } else if (depth == 3) {
+      in_scores = (value == "Score");
+      in_older = (value == "Older");
+    } else if (depth == 5 && in_bucket) {
+      bucket_field = (value == "Score")   ? &bucket_score
+                     : (value == "Games") ? &bucket_games
+                     : (value == "Best")  ? &bucket_best
+                                          : nullptr;
+    }
+    return true;
+  }
+
+  bool end_object() override {
+    if (depth == 2 && player != nullptr) {
+      analytics.PlayerDone();
+      player = nullptr;
+    } else if (depth == 5 && in_bucket) {
+      in_bucket = false;
+      if (player != nullptr && level >= 0 && bucket_games >= 1 && bucket_score <= kMaxScore &&
+          bucket_best <= kMaxScore) {
+        player->older[level].push_back(ScoreAnalytics::OlderBucket{std::max(0.0, bucket_score),
+                                                                   static_cast<std::uint64_t>(bucket_games),
+                                                                   static_cast<int>(std::max(0.0, bucket_best))});
+      }
+      bucket_score = bucket_games = bucket_best = 0.0;
+    }
+    depth--;
+    return true;
+  }
+
+  bool start_array(std::size_t) override {
+    depth++;
+    collecting = (depth == 4 && player != nullptr && level >= 0 && in_scores);
+    return true;
+  }
+
+  bool end_array() override {
+    depth--;
+    collecting = false;
+    return true;
+  }
+
+  bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &) override { return false; }
+
+ private:
+  ScoreAnalytics &analytics;
+  ScoreAnalytics::PlayerScores *player{nullptr};
+  int depth{0};
+  int level{-1};
+  bool in_scores{false};
+  bool in_older{false};
+  bool collecting{false};
+  bool in_bucket{false};
+  double bucket_score{0.0};
+  double bucket_games{0.0};
+  double bucket_best{0.0};
+  double *bucket_field{nullptr};
+
+  static constexpr double kMaxScore{1 << 24};
+
+  bool Number(double value) {
+    if (collecting && value <= kMaxScore) {
+      player->scores[level].push_back(static_cast<int>(std::max(0.0, value)));
+    } else if (in_bucket && depth == 5 && bucket_field != nullptr) {
+      *bucket_field = value;
+      bucket_field = nullptr;
+    }
+    return true;
+  }
+};
+}  // namespace
+
+/**
+ * @brief Adds one score.
+ *
+ * @param score The score; must not be negative.
+ */
+void LevelStats::Add(int score) {
+  if (count == 0 || score < min) min = score;
+  if (count == 0 || score > max) max = score;
+  count++;
+  sum += score;
+  if (static_cast<std::size_t>(score) >= counts.size()) {
+    counts.resize(score + 1, 0);
+  }
+  counts[score]++;
+}
+
+/**
+ * @brief Adds the games of one downsampled bucket, counted at the bucket's mean score.
+ *
+ * @param mean The mean score of the games; must not be negative.
+ * @param games The number of games.
+ * @param best The best score of the games, which keeps the max exact.
+ */
+void LevelStats::AddDownsampled(double mean, std::uint64_t games, int best) {
+  int const score = static_cast<int>(std::lround(mean));
+  if (count == 0 || score < min) min = score;
+  if (count == 0 || best > max) max = best;
+  count += games;
+  downsampled += games;
+  sum += mean * static_cast<double>(games);
+  // Cover the best too: the histogram reads counts up to max.
+  std::size_t const highest = static_cast<std::size_t>(std::max(score, best));
+  if (highest >= counts.size()) {
+    counts.resize(highest + 1, 0);
+  }
+  counts[score] += games;
+}
+
+/**
+ * @brief Adds the scores of another set of statistics.
+ *
+ * @param other The statistics to merge in.
+ */
+void LevelStats::Merge(const LevelStats &other) {
+  if (other.count == 0) return;
+  if (count == 0 || other.min < min) min = other.min;
+  if (count == 0 || other.max > max) max = other.max;
+  count += other.count;
+  downsampled += other.downsampled;
+  sum += other.sum;
+  if (other.counts.size() > counts.size()) {
+    counts.resize(other.counts.size(), 0);
+  }
+  for (std::size_t i = 0; i < other.counts.size(); ++i) {
+    counts[i] += other.counts[i];
+  }
+}
+
+/**
+ * @brief Returns a nearest-rank percentile.
+ *
+ * @param fraction The percentile as a fraction in (0, 1].
+ *
+ * @return The smallest score such that at least fraction of the games scored at most that much.
+ */
+int LevelStats::Percentile(double fraction) const {
+  std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(fraction * count)));
+  std::uint64_t seen = 0;
+  for (std::size_t score = 0; score < counts.size(); ++score) {
+    seen += counts[score];
+    if (seen >= rank) return static_cast<int>(score);
+  }
+  return max;
+}
+
+/**
+ * @brief Creates the report writer.
+ *
+ * @param thread_count The number of threads used to reduce each batch of players.
+ * @param output The stream the JSON report is written to.
+ */
+ScoreAnalytics::ScoreAnalytics(std::size_t thread_count, std::ostream &output)
+    : workers(thread_count), output(output), partials(workers.Size()) {}
+
+/**
+ * @brief Returns the record to fill for the next player of the current batch.
+ */
+ScoreAnalytics::PlayerScores &ScoreAnalytics::NextPlayer(void) {
+  Batch_t &batch = batches[filling];
+  if (batch.players.size() <= batch.size) {
+    batch.players.resize(batch.size + 1);
+  }
+  PlayerScores &player = batch.players[batch.size];
+  for (auto &scores : player.scores) {
+    scores.clear();
+  }
+  for (auto &older : player.older) {
+    older.clear();
+  }
+  return player;
+}
+
+/**
+ * @brief Commits the player returned by NextPlayer(), reducing the batch once it is full.
+ */
+void ScoreAnalytics::PlayerDone(void) {
+  if (++batches[filling].size == kBatchSize) {
+    StartReduce();
+  }
+}
+
+/**
+ * @brief Reduces the current batch in the background and starts filling the other one.
+ *
+ * The previous reduction is finished first, so at most one batch is reduced while the other is
+ * filled, and bests are written in database order.
+ */
+void ScoreAnalytics::StartReduce(void) {
+  FinishReduce();
+  Batch_t &batch = batches[filling];
+  reducing = std::async(std::launch::async, [this, &batch] { Reduce(batch); });
+  filling ^= 1;
+  batches[filling].size = 0;
+}
+
+/**
+ * @brief Waits for the batch being reduced, if any.
+ */
+void ScoreAnalytics::FinishReduce(void) {
+  if (reducing.valid()) {
+    reducing.get();
+  }
+}
+
+/**
+ * @brief Computes the bests of a batch and merges its scores into the totals.
+ *
+ * Each range of players is reduced into its own partial statistics without locking; the
+ * partials are then merged in a short sequential pass.
+ *
+ * @param batch The batch to reduce.
+ */
+void ScoreAnalytics::Reduce(Batch_t &batch) {
+  for (auto &partial : partials) {
+    for (auto &stats : partial) {
+      stats = LevelStats_t{};
+    }
+  }
+  batch.bests.resize(batch.size);
+
+  std::atomic<std::size_t> next_partial{0};
+  auto reduce = [this, &batch, &next_partial](std::size_t begin, std::size_t end) {
+    auto &partial = partials[next_partial.fetch_add(1)];
+    for (std::size_t i = begin; i < end; ++i) {
+      for (std::size_t level = 0; level < kLevelCount; ++level) {
+        int best = -1;
+        for (int score : batch.players[i].scores[level]) {
+          partial[level].Add(score);
+          best = std::max(best, score);
+        }
+        for (auto const &older : batch.players[i].older[level]) {
+          partial[level].AddDownsampled(older.score, older.games, older.best);
+          best = std::max(best, older.best);
+        }
+        batch.bests[i][level] = best;
+      }
+    }
+  };
+  workers.ParallelFor(batch.size, reduce);
+
+  for (auto const &partial : partials) {
+    for (std::size_t level = 0; level < kLevelCount; ++level) {
+      totals[level].Merge(partial[level]);
+    }
+  }
+  player_count += batch.size;
+  WriteBests(batch);
+}
+
+/**
+ * @brief Writes the best score per level of every player of a batch.
+ *
+ * @param batch The reduced batch.
+ */
+void ScoreAnalytics::WriteBests(const Batch_t &batch) {
+  for (std::size_t i = 0; i < batch.size; ++i) {
+    output << (first_player ? "\n    " : ",\n    ") << json(batch.players[i].name).dump() << ": {";
+    first_player = false;
+    bool first_level = true;
+    for (std::size_t level = 0; level < kLevelCount; ++level) {
+      if (batch.bests[i][level] < 0) continue;
+      output << (first_level ? "" : ", ") << '"' << Parser::LevelToString(static_cast<int>(level) + 1)
+             << "\": " << batch.bests[i][level];
+      first_level = false;
+    }
+    output << "}";
+  }
+}
+
+/**
+ * @brief Writes the per-level statistics.
+ */
+void ScoreAnalytics::WriteLevels(void) {
+  json levels = json::object();
+  for (std::size_t level = 0; level < kLevelCount; ++level) {
+    LevelStats_t const &stats = totals[level];
+    json entry;
+    entry["count"] = stats.count;
+    if (stats.count > 0) {
+      entry["mean"] = stats.sum / static_cast<double>(stats.count);
+      entry["min"] = stats.min;
+      entry["max"] = stats.max;
+      entry["p50"] = stats.Percentile(0.50);
+      entry["p90"] = stats.Percentile(0.90);
+      entry["p99"] = stats.Percentile(0.99);
+      if (stats.downsampled > 0) {
+        // Min, percentiles and histogram place these games at their bucket's mean score.
+        entry["downsampled"] = stats.downsampled;
+      }
+
+      // Equal-width buckets over [min, max].
+      int width = std::max(1, (stats.max - stats.min + kHistogramBuckets) / kHistogramBuckets);
+      json histogram = json::array();
+      for (int from = stats.min; from <= stats.max; from += width) {
+        std::uint64_t bucket = 0;
+        for (int score = from; score < from + width && score <= stats.max; ++score) {
+          bucket += stats.counts[score];
+        }
+        histogram.push_back({{"from", from}, {"to", std::min(from + width - 1, stats.max)}, {"count", bucket}});
+      }
+      entry["histogram"] = histogram;
+    }
+    levels[Parser::LevelToString(static_cast<int>(level) + 1)] = entry;
+  }
+  output << ",\n  \"player_count\": " << player_count << ",\n  \"levels\": " << levels.dump() << "\n}" << std::endl;
+}
+
+/**
+ * @brief Streams a score database and writes the report.
+ *
+ * @param input The JSON score database.
+ *
+ * @return True if the whole database was parsed; otherwise the report is incomplete.
+ */
+bool ScoreAnalytics::Run(std::istream &input) {
+  output << "{\n  \"players\": {";
+  ScoreSax sax(*this);
+  bool parsed = json::sax_parse(input, &sax);
+  if (parsed && batches[filling].size > 0) {
+    StartReduce();
+  }
+  FinishReduce();
+  output << (first_player ? "}" : "\n  }");
+  if (parsed) {
+    WriteLevels();
+  }
+  return parsed;
+}
@@ -0,0 +1,100 @@
+#ifndef SCORE_ANALYTICS_H
+#define SCORE_ANALYTICS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "worker_pool.h"
+
+/**
+ * @brief Aggregated statistics of the scores of one level.
+ *
+ * Scores are kept as a count per score value, so partial results merge by
+ * adding counts and percentiles are exact. Games only known from a
+ * downsampled bucket count at the bucket's mean score: the count, sum and
+ * max stay exact, while min, percentiles and histogram are approximate for
+ * those games.
+ */
+typedef struct LevelStats {
+  std::uint64_t count{0};
+  double sum{0.0};
+  int min{0};
+  int max{0};
+  std::uint64_t downsampled{0};       // Games counted from downsampled buckets
+  std::vector<std::uint64_t> counts;  // counts[score] = number of games with that score
+
+  void Add(int score);
+  void AddDownsampled(double mean, std::uint64_t games, int best);
+  void Merge(const LevelStats &other);
+  int Percentile(double fraction) const;
+} LevelStats_t;
+
+/**
+ * @brief Non-interactive score report (SnakeGame --stats).
+ *
+ * The score database is read with a streaming (SAX) parser, so it is never
+ * held in memory as a whole. Each level counts the retained raw scores and
+ * the downsampled "Older" buckets, so every game ever saved is included. Players are collected in fixed-size batches;
+ * while the parser fills one batch, the previous one is reduced in parallel
+ * by a WorkerPool into per-range partial LevelStats, which are then merged.
+ * Per-player bests are written as each batch completes, and the per-level
+ * count, mean, percentiles and histogram are written at the end. The output
+ * is one JSON object.
+ */
+class ScoreAnalytics {
+ public:
+  static constexpr std::size_t kLevelCount{3};
+
+  ScoreAnalytics(std::size_t thread_count, std::ostream &output);
+
+  bool Run(std::istream &input);
+
+  // One bucket of games dropped from the raw scores (see ScoreHistory).
+  struct OlderBucket {
+    double score{0.0};  // Mean score
+    std::uint64_t games{0};
+    int best{0};
+  };
+
+  // Called by the parser for every player it completes.
+  struct PlayerScores {
+    std::string name;
+    std::array<std::vector<int>, kLevelCount> scores;
+    std::array<std::vector<OlderBucket>, kLevelCount> older;
+  };
+  PlayerScores &NextPlayer(void);
+  void PlayerDone(void);
+
+ private:
+  static constexpr std::size_t kBatchSize{4096};
+  static constexpr int kHistogramBuckets{10};
+
+  typedef struct Batch {
+    std::vector<PlayerScores> players;
+    std::vector<std::array<int, kLevelCount>> bests;  // -1 when the level was not played
+    std::size_t size{0};
+  } Batch_t;
+
+  WorkerPool workers;
+  std::ostream &output;
+  std::array<Batch_t, 2> batches;
+  std::size_t filling{0};
+  std::future<void> reducing;
+  std::vector<std::array<LevelStats_t, kLevelCount>> partials;
+  std::array<LevelStats_t, kLevelCount> totals;
+  std::uint64_t player_count{0};
+  bool first_player{true};
+
+  void StartReduce(void);
+  void FinishReduce(void);
+  void Reduce(Batch_t &batch);
+  void WriteBests(const Batch_t &batch);
+  void WriteLevels(void);
+};
+
+#endif /* SCORE_ANALYTICS_H */
@@ -0,0 +1,158 @@
+#include "score_history.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace {
+/**
+ * @brief Returns the histogram bucket of a score.
+ *
+ * Bucket 0 holds scores up to 0 and bucket b holds [2^(b-1), 2^b - 1]; the last bucket also holds
+ * every larger score.
+ */
+std::size_t Bucket(int score) {
+  std::size_t bucket = 0;
+  for (unsigned value = static_cast<unsigned>(std::max(score, 0)); value != 0; value >>= 1) {
+    bucket++;
+  }
+  return std::min(bucket, ScoreHistory::kHistogramBuckets - 1);
+}
+
+/**
+ * @brief Returns the score or size stored at a position of a raw array, or 0 if there is none.
+ */
+int RawAt(json const &values, std::size_t index) {
+  if (!values.is_array() || index >= values.size() || !values[index].is_number()) return 0;
+  return values[index].get<int>();
+}
+
+/**
+ * @brief Counts one game into the aggregates.
+ */
+void AddToStats(json &stats, int score) {
+  stats["Count"] = stats["Count"].get<std::uint64_t>() + 1;
+  stats["Sum"] = stats["Sum"].get<std::int64_t>() + score;
+  if (score > stats["Best"].get<int>()) {
+    stats["Best"] = score;
+  }
+  json &bucket = stats["Histogram"][Bucket(score)];
+  bucket = bucket.get<std::uint64_t>() + 1;
+}
+
+/**
+ * @brief Creates the aggregates of a level entry from its raw arrays.
+ *
+ * Entries written before aggregates existed hold every game in "Score", so this counts them all.
+ */
+json MakeStats(json const &level) {
+  json stats = {{"Count", 0}, {"Sum", 0}, {"Best", -1}};
+  stats["Histogram"] = json(std::vector<std::uint64_t>(ScoreHistory::kHistogramBuckets, 0));
+  json const &scores = level["Score"];
+  for (std::size_t i = 0; i < scores.size(); ++i) {
+    AddToStats(stats, RawAt(scores, i));
+  }
+  return stats;
+}
+
+/**
+ * @brief Merges the buckets of the downsampled history in adjacent pairs.
+ */
+void MergeOlder(json &older) {
+  json merged = json::array();
+  for (std::size_t i = 0; i < older.size(); i += 2) {
+    if (i + 1 == older.size()) {
+      merged.push_back(older[i]);
+      break;
+    }
+    json const &first = older[i];
+    json const &second = older[i + 1];
+    double const games_first = first["Games"].get<double>();
+    double const games_second = second["Games"].get<double>();
+    double const games = games_first + games_second;
+    merged.push_back({
+        {"Games", first["Games"].get<std::uint64_t>() + second["Games"].get<std::uint64_t>()},
+        {"Score", (first["Score"].get<double>() * games_first + second["Score"].get<double>() * games_second) / games},
+        {"Size", (first["Size"].get<double>() * games_first + second["Size"].get<double>() * games_second) / games},
+        {"Best", std::max(first["Best"].get<int>(), second["Best"].get<int>())},
+    });
+  }
+  older = std::move(merged);
+}
+}  // namespace
+
+namespace ScoreHistory {
+/**
+ * @brief Records one game into a level entry and drops raw entries beyond the retention window.
+ *
+ * Dropped games are downsampled into the "Older" buckets. A full bucket list is merged in pairs
+ * about every kOlderBuckets / 2 dropped games, so recording costs O(retention + kOlderBuckets)
+ * whatever the number of games played.
+ *
+ * @param level The level entry of the player; created if it is not an object yet.
+ * @param score The score of the game.
+ * @param size The snake's size at the end of the game.
+ * @param retention The number of recent games kept as raw entries.
+ */
+void Record(json &level, int score, int size, std::size_t retention) {
+  if (!level.is_object()) {
+    level = json::object();
+  }
+  for (char const *key : {"Score", "Size"}) {
+    if (!level[key].is_array()) {
+      level[key] = json::array();
+    }
+  }
+  if (!level["Stats"].is_object()) {
+    level["Stats"] = MakeStats(level);
+  }
+  AddToStats(level["Stats"], score);
+  level["Score"].push_back(score);
+  level["Size"].push_back(size);
+
+  json &scores = level["Score"];
+  json &sizes = level["Size"];
+  if (scores.size() <= retention) return;
+
+  std::size_t const dropped = scores.size() - retention;
+  json &older = level["Older"];
+  if (!older.is_array()) {
+    older = json::array();
+  }
+  for (std::size_t i = 0; i < dropped; ++i) {
+    int const old_score = RawAt(scores, i);
+    older.push_back({{"Games", 1}, {"Score", old_score}, {"Size", RawAt(sizes, i)}, {"Best", old_score}});
+    if (older.size() > kOlderBuckets) {
+      MergeOlder(older);
+    }
+  }
+  scores.erase(scores.begin(), scores.begin() + dropped);
+  sizes.erase(sizes.begin(), sizes.begin() + std::min(dropped, sizes.size()));
+}
+
+/**
+ * @brief Returns the best score of a level entry.
+ *
+ * Entries with aggregates answer in O(1); older entries are scanned.
+ *
+ * @param level The level entry of the player.
+ *
+ * @return The best score, or -1 if no game was recorded.
+ */
+int Best(json const &level) {
+  if (!level.is_object()) return -1;
+  auto stats = level.find("Stats");
+  if (stats != level.end() && stats->is_object() && stats->contains("Best")) {
+    return (*stats)["Best"].get<int>();
+  }
+  int best = -1;
+  auto scores = level.find("Score");
+  if (scores != level.end() && scores->is_array()) {
+    for (std::size_t i = 0; i < scores->size(); ++i) {
+      best = std::max(best, RawAt(*scores, i));
+    }
+  }
+  return best;
+}
+}  // namespace ScoreHistory
@@ -0,0 +1,29 @@
+#ifndef SCORE_HISTORY_H
+#define SCORE_HISTORY_H
+
+#include <cstddef>
+#include <nlohmann/json.hpp>
+
+/**
+ * @brief Bounded score history of one player on one level, stored in the score database.
+ *
+ * A level entry holds the raw "Score" and "Size" arrays of the most recent
+ * games only, at most the retention window. Every game is also counted into
+ * "Stats" (count, sum, best and a histogram of power-of-two score buckets),
+ * so totals stay exact after raw entries are dropped. Dropped games are
+ * downsampled into "Older", at most kOlderBuckets buckets of mean score, mean
+ * size and best; when it is full, adjacent buckets are merged in pairs, so the
+ * oldest games are the most coarsely summarised. An entry therefore has a
+ * bounded size however many games were played. Entries written before
+ * "Stats" existed are migrated the first time a game is recorded into them.
+ */
+namespace ScoreHistory {
+constexpr std::size_t kDefaultRetention{100};
+constexpr std::size_t kHistogramBuckets{16};
+constexpr std::size_t kOlderBuckets{32};
+
+void Record(nlohmann::json &level, int score, int size, std::size_t retention);
+int Best(nlohmann::json const &level);
+}  // namespace ScoreHistory
+
+#endif /* SCORE_HISTORY_H */
@@ -1,79 +1,98 @@
 #include "snake.h"
-#include <cmath>
 #include <iostream>
 
-void Snake::Update() {
-  SDL_Point prev_cell{
-      static_cast<int>(head_x),
-      static_cast<int>(
-          head_y)};  // We first capture the head's cell before updating.
-  UpdateHead();
-  SDL_Point current_cell{
-      static_cast<int>(head_x),
-      static_cast<int>(head_y)};  // Capture the head's cell after updating.
-
-  // Update all of the body vector items if the snake head has moved to a new
-  // cell.
-  if (current_cell.x != prev_cell.x || current_cell.y != prev_cell.y) {
-    UpdateBody(current_cell, prev_cell);
-  }
+/**
+ * @brief Adds the distance travelled in one tick.
+ *
+ * @return The number of whole cells to move this tick; each is taken with StepCell().
+ */
+int Snake::Advance() {
+  progress += speed;
+  int steps = static_cast<int>(progress);
+  progress -= steps;
+  return steps;
 }
 
-void Snake::UpdateHead() {
+/**
+ * @brief Moves the head one cell, then updates the body and checks for self-collision.
+ */
+void Snake::StepCell() {
+  Cell prev_cell = HeadCell();
+
+  // The board wraps the Snake around to the other side when it leaves the grid.
   switch (direction) {
     case Direction::kUp:
-      head_y -= speed;
+      head = board.Move(head, 0, -1);
       break;
 
     case Direction::kDown:
-      head_y += speed;
+      head = board.Move(head, 0, 1);
       break;
 
     case Direction::kLeft:
-      head_x -= speed;
+      head = board.Move(head, -1, 0);
       break;
 
     case Direction::kRight:
-      head_x += speed;
+      head = board.Move(head, 1, 0);
       break;
   }
 
-  // Wrap the Snake around to the beginning if going off of the screen.
-  head_x = fmod(head_x + grid_width, grid_width);
-  head_y = fmod(head_y + grid_height, grid_height);
+  UpdateBody(HeadCell(), prev_cell);
 }
 
-void Snake::UpdateBody(SDL_Point &current_head_cell, SDL_Point &prev_head_cell) {
+void Snake::UpdateBody(Cell current_head_cell, Cell prev_head_cell) {
   // Add previous head location to vector
   body.push_back(prev_head_cell);
+  occupied.Insert(prev_head_cell);
+  cells_added++;
 
   if (!growing) {
     // Remove the tail from the vector.
-    body.erase(body.begin());
+    occupied.Erase(body.front());
+    body.pop_front();
   } else {
     growing = false;
     size++;
   }
 
   // Check if the snake has died.
-  for (auto const &item : body) {
-    if (current_head_cell.x == item.x && current_head_cell.y == item.y) {
-      alive = false;
-    }
+  if (occupied.Contains(current_head_cell)) {
+    alive = false;
   }
 }
 
 void Snake::GrowBody() { growing = true; }
 
-// Inefficient method to check if cell is occupied by snake.
-bool Snake::SnakeCell(int x, int y) {
-  if (x == static_cast<int>(head_x) && y == static_cast<int>(head_y)) {
-    return true;
+/**
+ * @brief Drops cells from the tail; the head always stays.
+ *
+ * @param cells The number of cells to drop; fewer are dropped when the body is shorter.
+ */
+void Snake::Shrink(int cells) {
+  for (; cells > 0 && !body.empty(); --cells) {
+    occupied.Erase(body.front());
+    body.pop_front();
+    size--;
   }
-  for (auto const &item : body) {
-    if (x == item.x && y == item.y) {
-      return true;
-    }
+}
+
+bool Snake::SnakeCell(Cell cell) const {
+  return cell == HeadCell() || occupied.Contains(cell);
+}
+
+/**
+ * @brief Replaces the body with saved cells.
+ *
+ * @param cells The body cells, tail first.
+ * @param added The number of cells appended to the body so far (cells_added).
+ */
+void Snake::RestoreBody(std::vector<Cell> const &cells, std::uint64_t added) {
+  body.clear();
+  occupied.Clear();
+  for (Cell const &cell : cells) {
+    body.push_back(cell);
+    occupied.Insert(cell);
   }
-  return false;
+  cells_added = added;
 }
\ No newline at end of file
@@ -1,41 +1,62 @@
 #ifndef SNAKE_H
 #define SNAKE_H
 
+#include <cstdint>
 #include <vector>
-#include "SDL.h"
+#include "board.h"
+#include "cell.h"
+#include "cell_hash_set.h"
+#include "cell_queue.h"
 
 class Snake {
  public:
   enum class Direction { kUp, kDown, kLeft, kRight };
 
   Snake(int grid_width, int grid_height)
-      : grid_width(grid_width),
-        grid_height(grid_height),
-        head_x(grid_width / 2),
-        head_y(grid_height / 2) {}
-
-  void Update();
+      : head(grid_width / 2, grid_height / 2),
+        board(grid_width, grid_height) {
+    occupied.Reserve(kInitialBodyCapacity);
+  }
+
+  // Movement is swept one cell at a time, so at speeds above one cell per tick
+  // no cell is skipped: Advance() returns how many cells to move this tick and
+  // the caller checks each cell reached by StepCell().
+  int Advance();
+  void StepCell();
   void GrowBody();
-  bool SnakeCell(int x, int y);
-  
+  void Shrink(int cells);
+  bool SnakeCell(Cell cell) const;
+  void RestoreBody(std::vector<Cell> const &cells, std::uint64_t added);
+  Cell HeadCell() const { return head; }
+  CellHashSet const &BodyCells() const { return occupied; }
+  bool Growing() const { return growing; }
+
   Direction direction = Direction::kUp;
   float speed{0.1f};
   int size{1};
   bool alive{true};
-  float head_x;
-  float head_y;
-  std::vector<SDL_Point> body;
+  Cell head;
+  // Fraction of the next cell already travelled; a step is taken each time it reaches 1.
+  float progress{0.0f};
+  CellQueue body{kInitialBodyCapacity};
 
-  int GetGridWidth() const { return grid_width; }
-  int GetGridHeight() const { return grid_height; }
+  // Total number of cells ever appended to body. body[i] is cell number
+  // cells_added - body.size() + i, which lets observers send only new cells.
+  std::uint64_t cells_added{0};
+
+  int GetGridWidth() const { return board.Width(); }
+  int GetGridHeight() const { return board.Height(); }
 
  private:
-  void UpdateHead();
-  void UpdateBody(SDL_Point &current_cell, SDL_Point &prev_cell);
+  // Pre-sized so that ordinary games never reallocate the body or its cell set.
+  static constexpr std::size_t kInitialBodyCapacity{1024};
+
+  void UpdateBody(Cell current_cell, Cell prev_cell);
 
   bool growing{false};
-  int grid_width;
-  int grid_height;
+  // The cells of body, for constant-time collision checks.
+  CellHashSet occupied;
+  Board board;
 };
 
 #endif
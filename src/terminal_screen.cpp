@@ -0,0 +1,151 @@
+#include "terminal_screen.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+// 256-color background of each glyph, close to the colors of the SDL renderer.
+constexpr int kGlyphColors[TerminalScreen::kGlyphCount]{234, 220, 248, 255, 32, 196, 45, 206, 183};
+}  // namespace
+
+/**
+ * @brief Creates a screen; nothing is written to the terminal until Open().
+ *
+ * @param width Width of the board area in cells (two columns each).
+ * @param height Height of the board area in rows; a status line is drawn below it.
+ */
+TerminalScreen::TerminalScreen(std::size_t width, std::size_t height)
+    : width(width), height(height), cells(width * height, kEmpty), shown(width * height, kGlyphCount) {
+  // Enough for a frame that redraws every cell, so presenting never allocates.
+  output.reserve(width * height * 24 + 128);
+}
+
+TerminalScreen::~TerminalScreen() {
+  Close();
+}
+
+/**
+ * @brief Switches to the alternate screen, hides the cursor and clears the screen.
+ */
+void TerminalScreen::Open(void) {
+  if (open) return;
+  open = true;
+  std::fill(shown.begin(), shown.end(), kGlyphCount);
+  color = kGlyphCount;
+  cursor_known = false;
+  Write("\x1b[?1049h\x1b[?25l\x1b[0m\x1b[2J");
+}
+
+/**
+ * @brief Restores the terminal and prints how many bytes the frames took.
+ */
+void TerminalScreen::Close(void) {
+  if (!open) return;
+  open = false;
+  Write("\x1b[0m\x1b[?25h\x1b[?1049l");
+  std::cout << "Terminal output: " << bytes_written << " bytes in " << frames << " frames ("
+            << (frames ? bytes_written / frames : 0) << " bytes per frame)" << std::endl;
+}
+
+/**
+ * @brief Starts a new frame with every cell empty.
+ */
+void TerminalScreen::Clear(void) {
+  std::fill(cells.begin(), cells.end(), kEmpty);
+}
+
+/**
+ * @brief Sets the status line shown below the board; it is drawn by the next Present().
+ *
+ * @param score The current score.
+ * @param fps The frames rendered during the last second.
+ * @param state Shown after the FPS when not null, such as "Paused".
+ */
+void TerminalScreen::SetStatus(int score, int fps, const char *state) {
+  if (state != nullptr) {
+    std::snprintf(status, sizeof(status), "Snake Score: %d FPS: %d - %s", score, fps, state);
+  } else {
+    std::snprintf(status, sizeof(status), "Snake Score: %d FPS: %d", score, fps);
+  }
+  status_changed = true;
+}
+
+/**
+ * @brief Appends a cursor move to the output, unless the cursor is already there.
+ *
+ * @param column The 0-based cell column.
+ * @param row The 0-based row.
+ */
+void TerminalScreen::MoveCursor(std::size_t column, std::size_t row) {
+  if (cursor_known && cursor_x == column && cursor_y == row) return;
+  char move[32];
+  int length = std::snprintf(move, sizeof(move), "\x1b[%zu;%zuH", row + 1, 2 * column + 1);
+  output.append(move, length);
+  cursor_x = column;
+  cursor_y = row;
+  cursor_known = true;
+}
+
+/**
+ * @brief Draws the cells that changed since the previous frame.
+ *
+ * Runs of changed cells in a row are written without cursor moves between them, and the color
+ * is only sent when it differs from the previous cell written.
+ */
+void TerminalScreen::Present(void) {
+  if (!open) return;
+  output.clear();
+
+  for (std::size_t y = 0; y < height; ++y) {
+    for (std::size_t x = 0; x < width; ++x) {
+      std::size_t const i = y * width + x;
+      if (cells[i] == shown[i]) continue;
+
+      MoveCursor(x, y);
+      if (cells[i] != color) {
+        char sgr[16];
+        int length = std::snprintf(sgr, sizeof(sgr), "\x1b[48;5;%dm", kGlyphColors[cells[i]]);
+        output.append(sgr, length);
+        color = cells[i];
+      }
+      output.append("  ", 2);
+      cursor_x++;
+      shown[i] = cells[i];
+    }
+  }
+
+  if (status_changed) {
+    MoveCursor(0, height);
+    output.append("\x1b[0m");
+    output.append(status);
+    output.append("\x1b[K");
+    color = kGlyphCount;
+    cursor_known = false;
+    status_changed = false;
+  }
+
+  frames++;
+  if (!output.empty()) {
+    Write(output);
+  }
+}
+
+/**
+ * @brief Writes text to the terminal, retrying partial writes.
+ *
+ * @param text The bytes to write.
+ */
+void TerminalScreen::Write(const std::string &text) {
+  std::size_t done = 0;
+  while (done < text.size()) {
+    ssize_t written = write(STDOUT_FILENO, text.data() + done, text.size() - done);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    done += static_cast<std::size_t>(written);
+  }
+  bytes_written += done;
+}
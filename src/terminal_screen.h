@@ -0,0 +1,62 @@
+#ifndef TERMINAL_SCREEN_H
+#define TERMINAL_SCREEN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Character-cell screen drawn in the terminal with ANSI escape codes.
+ *
+ * Each board cell is two columns wide, so cells are about square. The screen
+ * keeps the glyphs currently shown by the terminal; Present() compares them
+ * with the frame being built and only emits cursor moves, color changes and
+ * text for the cells that changed, all in one write(). An unchanged frame
+ * writes nothing, so a game is playable over a slow SSH link.
+ */
+class TerminalScreen {
+ public:
+  enum Glyph : std::uint8_t {
+    kEmpty, kFood, kObstacle, kBody, kHead, kDeadHead, kSpeed, kShrink, kGhost, kGlyphCount
+  };
+
+  TerminalScreen(std::size_t width, std::size_t height);
+  ~TerminalScreen();
+
+  TerminalScreen(const TerminalScreen &other) = delete;
+  TerminalScreen &operator=(const TerminalScreen &other) = delete;
+
+  void Open(void);
+  void Close(void);
+
+  void Clear(void);
+  void Set(std::size_t x, std::size_t y, Glyph glyph) { cells[y * width + x] = glyph; }
+  void SetStatus(int score, int fps, const char *state = nullptr);
+  void Present(void);
+
+ private:
+  const std::size_t width;
+  const std::size_t height;
+  bool open{false};
+
+  std::vector<Glyph> cells;  // The frame being built
+  std::vector<Glyph> shown;  // What the terminal shows; kGlyphCount when unknown
+  char status[64]{};
+  bool status_changed{false};
+
+  // Terminal state left by the previous frame, so it is not sent again.
+  Glyph color{kGlyphCount};
+  std::size_t cursor_x{0};
+  std::size_t cursor_y{0};
+  bool cursor_known{false};
+
+  std::string output;
+  std::uint64_t bytes_written{0};
+  std::uint64_t frames{0};
+
+  void MoveCursor(std::size_t column, std::size_t row);
+  void Write(const std::string &text);
+};
+
+#endif /* TERMINAL_SCREEN_H */
@@ -0,0 +1,160 @@
+#include "timer_wheel.h"
+
+/**
+ * @brief Creates an empty wheel.
+ *
+ * @param next_tick The first tick Advance() will process.
+ */
+TimerWheel::TimerWheel(std::uint64_t next_tick) : nodes(kHeads), next_tick(next_tick) {
+  for (std::uint32_t head = 0; head < kHeads; ++head) {
+    nodes[head].prev = head;
+    nodes[head].next = head;
+  }
+}
+
+/**
+ * @brief Schedules an event.
+ *
+ * @param due The tick on which the event fires; a tick already processed means the next one.
+ * @param event The event handed to the handler of Advance().
+ * @param data A value handed to the handler with the event.
+ *
+ * @return The id of the timer, for Cancel().
+ */
+TimerWheel::TimerId TimerWheel::Schedule(std::uint64_t due, std::uint32_t event, std::uint32_t data) {
+  std::uint32_t index;
+  if (free_nodes != kNil) {
+    index = free_nodes;
+    free_nodes = nodes[index].next;
+  } else {
+    index = static_cast<std::uint32_t>(nodes.size());
+    nodes.push_back(Node_t{0, 0, 0, kNil, kNil, 1});
+  }
+  nodes[index].due = due;
+  nodes[index].event = event;
+  nodes[index].data = data;
+  Place(index);
+  size++;
+  return (static_cast<TimerId>(nodes[index].generation) << 32) | index;
+}
+
+/**
+ * @brief Cancels a timer.
+ *
+ * @param id The id returned by Schedule().
+ *
+ * @return False if the timer already fired or was cancelled.
+ */
+bool TimerWheel::Cancel(TimerId id) {
+  std::uint32_t const index = static_cast<std::uint32_t>(id);
+  if (index < kHeads || index >= nodes.size()) return false;
+  Node_t const &node = nodes[index];
+  if (node.prev == kNil || node.generation != static_cast<std::uint32_t>(id >> 32)) return false;
+  Release(index);
+  return true;
+}
+
+/**
+ * @brief Cancels every timer and moves the wheel to another tick, which may be an earlier one.
+ *
+ * @param next_tick The next tick Advance() will process.
+ */
+void TimerWheel::Reset(std::uint64_t next_tick) {
+  for (std::uint32_t index = kHeads; index < nodes.size(); ++index) {
+    if (nodes[index].prev != kNil) {
+      Release(index);
+    }
+  }
+  this->next_tick = next_tick;
+}
+
+/**
+ * @brief Links a timer into the slot for its due tick.
+ *
+ * The level is the lowest one whose span, counted from the next tick, reaches the due tick, and
+ * the slot is given by the due tick's bits for that level. A timer beyond the last level is
+ * placed in its furthest slot and placed again when that slot is collected.
+ *
+ * @param index The timer's node.
+ */
+void TimerWheel::Place(std::uint32_t index) {
+  Node_t &node = nodes[index];
+  if (node.due < next_tick) {
+    node.due = next_tick;
+  }
+  std::uint64_t const delta = node.due - next_tick;
+  std::uint64_t slot_tick = node.due;
+  unsigned level = 0;
+  while (level + 1 < kLevels && delta >> (kSlotBits * (level + 1)) != 0) {
+    level++;
+  }
+  if (delta >> (kSlotBits * kLevels) != 0) {
+    slot_tick = next_tick + (1ull << (kSlotBits * kLevels)) - 1;
+  }
+  Link(level * kSlots + ((slot_tick >> (kSlotBits * level)) & (kSlots - 1)), index);
+}
+
+/**
+ * @brief Appends a node to a circular list.
+ */
+void TimerWheel::Link(std::uint32_t head, std::uint32_t index) {
+  std::uint32_t const last = nodes[head].prev;
+  nodes[index].prev = last;
+  nodes[index].next = head;
+  nodes[last].next = index;
+  nodes[head].prev = index;
+}
+
+/**
+ * @brief Removes a node from the list it is in.
+ */
+void TimerWheel::Unlink(std::uint32_t index) {
+  Node_t &node = nodes[index];
+  nodes[node.prev].next = node.next;
+  nodes[node.next].prev = node.prev;
+}
+
+/**
+ * @brief Unlinks a timer and returns its node to the free list.
+ */
+void TimerWheel::Release(std::uint32_t index) {
+  Unlink(index);
+  Node_t &node = nodes[index];
+  node.prev = kNil;
+  node.next = free_nodes;
+  node.generation++;
+  free_nodes = index;
+  size--;
+}
+
+/**
+ * @brief Moves the timers due on a tick to the firing list.
+ *
+ * On a tick that starts a slot of a higher level, that slot's timers are placed again first,
+ * from the highest level down, so they reach the lower levels before those are collected.
+ *
+ * @param tick The tick being processed; equal to next_tick.
+ */
+void TimerWheel::Collect(std::uint64_t tick) {
+  for (unsigned level = kLevels - 1; level > 0; --level) {
+    if ((tick & ((1ull << (kSlotBits * level)) - 1)) != 0) continue;
+    std::uint32_t const head = level * kSlots + ((tick >> (kSlotBits * level)) & (kSlots - 1));
+    while (nodes[head].next != head) {
+      std::uint32_t const index = nodes[head].next;
+      Unlink(index);
+      Place(index);
+    }
+  }
+
+  // Every timer left in the level-0 slot is due on this tick; splice them all at once.
+  std::uint32_t const head = tick & (kSlots - 1);
+  if (nodes[head].next == head) return;
+  std::uint32_t const first = nodes[head].next;
+  std::uint32_t const last = nodes[head].prev;
+  nodes[kFiring].next = first;
+  nodes[kFiring].prev = last;
+  nodes[first].prev = kFiring;
+  nodes[last].next = kFiring;
+  nodes[head].next = head;
+  nodes[head].prev = head;
+}
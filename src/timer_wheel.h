@@ -0,0 +1,90 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Hierarchical timer wheel driven by simulation ticks.
+ *
+ * Four levels of 64 slots cover 2^24 ticks (over three days at 60 ticks per
+ * second); a timer due further out waits in the last level and is placed
+ * again when that slot comes round. Timers are nodes of one pool, linked into
+ * a circular list per slot, so scheduling and cancelling are O(1) and do not
+ * allocate once the pool has grown to the number of pending timers. A timer
+ * moves down at most once per level and fires on exactly its due tick, so
+ * the same schedule always fires the same events on the same ticks.
+ */
+class TimerWheel {
+ public:
+  // Identifies a scheduled timer; never kNoTimer, and not reused once the timer fired or was cancelled.
+  typedef std::uint64_t TimerId;
+  static constexpr TimerId kNoTimer{0};
+
+  explicit TimerWheel(std::uint64_t next_tick = 0);
+
+  TimerId Schedule(std::uint64_t due, std::uint32_t event, std::uint32_t data = 0);
+  bool Cancel(TimerId id);
+  void Reset(std::uint64_t next_tick);
+  std::size_t Size(void) const { return size; }
+
+  template <typename Handler>
+  void Advance(std::uint64_t tick, Handler &&handler);
+
+ private:
+  static constexpr unsigned kSlotBits{6};
+  static constexpr std::uint32_t kSlots{1u << kSlotBits};
+  static constexpr unsigned kLevels{4};
+  // One list head per slot, then the head of the timers being fired.
+  static constexpr std::uint32_t kFiring{kLevels * kSlots};
+  static constexpr std::uint32_t kHeads{kFiring + 1};
+  static constexpr std::uint32_t kNil{0xffffffffu};
+
+  typedef struct Node {
+    std::uint64_t due;
+    std::uint32_t event;
+    std::uint32_t data;
+    std::uint32_t prev;        // kNil while the node is free
+    std::uint32_t next;        // Next free node while the node is free
+    std::uint32_t generation;  // Changes when the node is freed, so stale ids cancel nothing
+  } Node_t;
+
+  std::vector<Node_t> nodes;  // The list heads, then the timers
+  std::uint32_t free_nodes{kNil};
+  std::uint64_t next_tick;    // The next tick Advance processes
+  std::size_t size{0};
+
+  void Place(std::uint32_t index);
+  void Link(std::uint32_t head, std::uint32_t index);
+  void Unlink(std::uint32_t index);
+  void Release(std::uint32_t index);
+  void Collect(std::uint64_t tick);
+};
+
+/**
+ * @brief Processes every tick up to and including the given one, firing the timers due.
+ *
+ * A timer is released before its handler runs, so handlers may schedule and cancel timers; one
+ * scheduled for the tick being processed fires on the next one. Timers due on the same tick
+ * fire in an unspecified but repeatable order.
+ *
+ * @param tick The last tick to process.
+ * @param handler Called as handler(event, data) for each timer that fires.
+ */
+template <typename Handler>
+void TimerWheel::Advance(std::uint64_t tick, Handler &&handler) {
+  while (next_tick <= tick) {
+    Collect(next_tick);
+    next_tick++;
+    while (nodes[kFiring].next != kFiring) {
+      std::uint32_t const index = nodes[kFiring].next;
+      std::uint32_t const event = nodes[index].event;
+      std::uint32_t const data = nodes[index].data;
+      Release(index);
+      handler(event, data);
+    }
+  }
+}
+
+#endif /* TIMER_WHEEL_H */
@@ -0,0 +1,44 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+
+/**
+ * @brief Lock-free triple buffer between one writer thread and one reader thread.
+ *
+ * The writer fills Back() and calls Publish(); the reader calls Acquire() and
+ * then reads Front(). Each side always owns one slot and the third slot is
+ * swapped atomically, so neither side ever waits for the other. Slots are
+ * reused, which keeps their allocated storage between frames.
+ */
+template <typename T>
+class TripleBuffer {
+ public:
+  // Writer side.
+  T &Back(void) { return slots_[back_]; }
+  void Publish(void) {
+    back_ = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel) & kIndexMask;
+  }
+
+  // Reader side. Returns true if a newer slot was published since the last call.
+  bool Acquire(void) {
+    if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) {
+      return false;
+    }
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & kIndexMask;
+    return true;
+  }
+  const T &Front(void) const { return slots_[front_]; }
+
+ private:
+  static constexpr unsigned kIndexMask{3};
+  static constexpr unsigned kFresh{4};
+
+  std::array<T, 3> slots_{};
+  std::atomic<unsigned> middle_{1};
+  unsigned back_{0};
+  unsigned front_{2};
+};
+
+#endif /* TRIPLE_BUFFER_H */
@@ -0,0 +1,92 @@
+#include "worker_pool.h"
+
+/**
+ * @brief Starts the worker threads.
+ *
+ * @param thread_count The total number of threads used by a loop, including the caller.
+ *                     A value of 0 or 1 runs every loop on the calling thread.
+ */
+WorkerPool::WorkerPool(std::size_t thread_count) {
+  for (std::size_t i = 1; i < thread_count; ++i) {
+    threads_.emplace_back(&WorkerPool::WorkerLoop, this, i - 1);
+  }
+}
+
+/**
+ * @brief Stops and joins the worker threads.
+ */
+WorkerPool::~WorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    stop_ = true;
+  }
+  cv_start_.notify_all();
+  for (auto &thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+}
+
+/**
+ * @brief Runs one range of the current loop.
+ *
+ * @param index The range to run, from 0 to Size() - 1.
+ */
+void WorkerPool::RunRange(std::size_t index) {
+  std::size_t ranges = Size();
+  std::size_t begin = count_ * index / ranges;
+  std::size_t end = count_ * (index + 1) / ranges;
+  if (begin < end) {
+    job_(context_, begin, end);
+  }
+}
+
+/**
+ * @brief Publishes a loop to the workers, runs the caller's range and waits for the others.
+ *
+ * @param count The number of items in the loop.
+ * @param job The type-erased loop body.
+ * @param context The callable passed to the loop body.
+ */
+void WorkerPool::Dispatch(std::size_t count, Job job, void *context) {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    job_ = job;
+    context_ = context;
+    count_ = count;
+    pending_ = threads_.size();
+    generation_++;
+  }
+  cv_start_.notify_all();
+
+  RunRange(threads_.size());
+
+  std::unique_lock<std::mutex> lock(mtx_);
+  cv_done_.wait(lock, [this] { return pending_ == 0; });
+}
+
+/**
+ * @brief Waits for loops and runs this worker's range of each one.
+ *
+ * @param index The range owned by this worker.
+ */
+void WorkerPool::WorkerLoop(std::size_t index) {
+  std::uint64_t seen = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      cv_start_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+      if (stop_) return;
+      seen = generation_;
+    }
+
+    RunRange(index);
+
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      pending_--;
+    }
+    cv_done_.notify_one();
+  }
+}
@@ -0,0 +1,59 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of threads running data-parallel loops.
+ *
+ * ParallelFor splits [0, count) into one contiguous range per thread, runs the
+ * last range on the calling thread and returns once every range is done. The
+ * callable is passed by pointer, so dispatching a loop does not allocate.
+ */
+class WorkerPool {
+ public:
+  explicit WorkerPool(std::size_t thread_count);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &other) = delete;
+  WorkerPool &operator=(const WorkerPool &other) = delete;
+
+  // fn is called as fn(begin, end) for disjoint ranges covering [0, count).
+  template <typename Fn>
+  void ParallelFor(std::size_t count, Fn &fn) {
+    Dispatch(count, &Invoke<Fn>, &fn);
+  }
+
+  // Number of ranges a loop is split into, including the calling thread.
+  std::size_t Size(void) const { return threads_.size() + 1; }
+
+ private:
+  using Job = void (*)(void *context, std::size_t begin, std::size_t end);
+
+  template <typename Fn>
+  static void Invoke(void *context, std::size_t begin, std::size_t end) {
+    (*static_cast<Fn *>(context))(begin, end);
+  }
+
+  void Dispatch(std::size_t count, Job job, void *context);
+  void WorkerLoop(std::size_t index);
+  void RunRange(std::size_t index);
+
+  std::vector<std::thread> threads_;
+  std::mutex mtx_;
+  std::condition_variable cv_start_;
+  std::condition_variable cv_done_;
+  Job job_{nullptr};
+  void *context_{nullptr};
+  std::size_t count_{0};
+  std::size_t pending_{0};
+  std::uint64_t generation_{0};
+  bool stop_{false};
+};
+
+#endif /* WORKER_POOL_H */
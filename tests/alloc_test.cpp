@@ -0,0 +1,133 @@
+// Checks that a warmed-up game ticks without heap allocations, both when only stepped and when
+// every tick also publishes a frame snapshot as the simulation thread does.
+// Built with SNAKE_COUNT_ALLOCATIONS, so AllocCounter::Count() counts every operator new.
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include "alloc_counter.h"
+#include "game.h"
+
+namespace {
+constexpr int kGridSide{32};
+
+constexpr int kGridCells{kGridSide * kGridSide};
+
+bool Blocked(Game const &game, Cell cell) {
+  return game.GetSnake().SnakeCell(cell) || game.GetObstacles().Contains(cell);
+}
+
+Cell Neighbour(Cell cell, int dx, int dy) {
+  return Cell((cell.x + dx + kGridSide) % kGridSide, (cell.y + dy + kGridSide) % kGridSide);
+}
+
+/**
+ * @brief Counts the free cells reachable from a cell, on the stack so the test does not allocate.
+ */
+int FreeArea(Game const &game, Cell start) {
+  std::array<bool, kGridCells> seen{};
+  std::array<Cell, kGridCells> pending;
+  int count = 0;
+  int size = 0;
+  pending[size++] = start;
+  seen[start.y * kGridSide + start.x] = true;
+  while (size > 0) {
+    Cell const cell = pending[--size];
+    count++;
+    for (auto const &step : {std::array<int, 2>{-1, 0}, {1, 0}, {0, -1}, {0, 1}}) {
+      Cell const next = Neighbour(cell, step[0], step[1]);
+      bool &visited = seen[next.y * kGridSide + next.x];
+      if (!visited && !Blocked(game, next)) {
+        visited = true;
+        pending[size++] = next;
+      }
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief Heads for the food without running into the body or obstacles, and away from pockets
+ * too small for the snake, so that the measured ticks include eating, growing and placing food.
+ */
+void Steer(Game &game) {
+  struct Move {
+    Snake::Direction direction;
+    int dx;
+    int dy;
+  };
+  static constexpr Move kMoves[] = {{Snake::Direction::kLeft, -1, 0},
+                                    {Snake::Direction::kRight, 1, 0},
+                                    {Snake::Direction::kUp, 0, -1},
+                                    {Snake::Direction::kDown, 0, 1}};
+  Cell const head = game.GetSnake().HeadCell();
+  Cell const food = game.GetFood();
+  Move const *best = nullptr;
+  bool best_roomy = false;
+  int best_area = 0;
+  int best_distance = 0;
+  for (Move const &move : kMoves) {
+    Cell const next = Neighbour(head, move.dx, move.dy);
+    if (Blocked(game, next)) continue;
+    int const area = FreeArea(game, next);
+    bool const roomy = area > game.GetSize();
+    int const distance = std::abs(food.x - next.x) + std::abs(food.y - next.y);
+    bool const better = (best == nullptr) || (roomy && !best_roomy) ||
+                        (roomy == best_roomy && (roomy ? distance < best_distance : area > best_area));
+    if (better) {
+      best = &move;
+      best_roomy = roomy;
+      best_area = area;
+      best_distance = distance;
+    }
+  }
+  if (best != nullptr) {
+    game.Steer(best->direction);
+  }
+}
+
+/**
+ * @brief Warms a game up, then counts the heap allocations of the measured ticks.
+ *
+ * @param level The level of the game.
+ * @param publish Whether every tick also publishes a frame snapshot.
+ *
+ * @return True if the measured ticks did not allocate.
+ */
+bool TicksWithoutAllocations(int level, bool publish) {
+  constexpr int kWarmupTicks{600};
+  constexpr int kMeasuredTicks{6000};
+
+  Game game(kGridSide, kGridSide, level);
+  for (int i = 0; i < kWarmupTicks; ++i) {
+    Steer(game);
+    game.Step(publish);
+  }
+
+  // Measure until the snake dies; the autopilot only steers the first cell of fast ticks.
+  int const warm_size = game.GetSize();
+  int ticks = 0;
+  std::uint64_t const before = AllocCounter::Count();
+  for (; ticks < kMeasuredTicks && game.GetSnake().alive; ++ticks) {
+    Steer(game);
+    game.Step(publish);
+  }
+  std::uint64_t const allocations = AllocCounter::Count() - before;
+
+  std::printf("Level %d%s: %llu heap allocations in %d ticks (size %d -> %d)\n", level,
+              publish ? " with frames" : "", static_cast<unsigned long long>(allocations), ticks, warm_size,
+              game.GetSize());
+  return allocations == 0;
+}
+}  // namespace
+
+int main() {
+  if (!AllocCounter::Enabled()) {
+    std::printf("Allocation counting is not compiled in\n");
+    return 1;
+  }
+
+  bool const stepped = TicksWithoutAllocations(1, false);
+  bool const published = TicksWithoutAllocations(3, true);
+  return (stepped && published) ? 0 : 1;
+}
@@ -0,0 +1,32 @@
+// Checks that the --stats histogram accounts for every game, including downsampled ones.
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <nlohmann/json.hpp>
+#include "score_analytics.h"
+
+int main() {
+  // The "Older" bucket's best is far above its mean, so the histogram spans scores that no game
+  // was counted at.
+  std::istringstream input(R"({
+    "p0": {"Easy": {"Score": [1, 2], "Size": [2, 3], "Older": [{"Games": 3, "Score": 5, "Size": 4, "Best": 20}]}}
+  })");
+  std::ostringstream output;
+  ScoreAnalytics analytics(2, output);
+  if (!analytics.Run(input)) {
+    std::printf("The score database was not parsed\n");
+    return 1;
+  }
+
+  nlohmann::json const report = nlohmann::json::parse(output.str());
+  nlohmann::json const &easy = report["levels"]["Easy"];
+  std::uint64_t const count = easy["count"].get<std::uint64_t>();
+  std::uint64_t histogram = 0;
+  for (auto const &bucket : easy["histogram"]) {
+    histogram += bucket["count"].get<std::uint64_t>();
+  }
+
+  std::printf("Games: %llu, in histogram: %llu, max: %d\n", static_cast<unsigned long long>(count),
+              static_cast<unsigned long long>(histogram), easy["max"].get<int>());
+  return (count == 5 && histogram == count && easy["max"].get<int>() == 20) ? 0 : 1;
+}
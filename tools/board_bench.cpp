@@ -0,0 +1,100 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "board.h"
+
+/*
+ * Measures wrap-around moves on the board (see src/board.h).
+ *
+ * Usage: SnakeBoardBench [moves]
+ *
+ * For each kind of board, the same random walk of single-cell steps is run
+ * through Board::Move, which calls the move function picked at construction,
+ * and through the generic double-modulo wrap; on a 32x32 board it is also run
+ * through FixedGeometry<32, 32>::Move, inlined at compile time. Every variant
+ * must end on the same cell. Prints nanoseconds per move.
+ */
+
+namespace {
+
+struct Step {
+  int dx;
+  int dy;
+};
+
+Cell ModuloMove(Cell cell, int dx, int dy, int width, int height) {
+  return Cell(((cell.x + dx) % width + width) % width, ((cell.y + dy) % height + height) % height);
+}
+
+template <typename MoveFunction>
+Cell Walk(const std::vector<Step> &steps, std::size_t moves, double &ns_per_move, MoveFunction &&move) {
+  Cell cell(0, 0);
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < moves; ++i) {
+    Step const &step = steps[i & (steps.size() - 1)];
+    cell = move(cell, step.dx, step.dy);
+  }
+  ns_per_move = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / moves;
+  return cell;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::size_t const moves = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+  if (moves == 0) {
+    std::cerr << "Usage: " << argv[0] << " [moves]" << std::endl;
+    return 1;
+  }
+
+  // A power-of-two number of steps, so the walk indexes them with a mask.
+  std::vector<Step> steps(4096);
+  std::mt19937 engine(1);
+  for (Step &step : steps) {
+    static constexpr Step kDirections[] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    step = kDirections[engine() % 4];
+  }
+
+  struct Case {
+    const char *name;
+    int width;
+    int height;
+  };
+  bool consistent = true;
+  for (Case const &test : {Case{"fixed 32x32", 32, 32}, Case{"masked 256x256", 256, 256},
+                           Case{"tables 100x100", 100, 100}}) {
+    Board const board(test.width, test.height);
+    int const width = board.Width();
+    int const height = board.Height();
+    double board_ns = 0.0;
+    double modulo_ns = 0.0;
+    Cell const by_board = Walk(steps, moves, board_ns, [&board](Cell cell, int dx, int dy) {
+      return board.Move(cell, dx, dy);
+    });
+    Cell const by_modulo = Walk(steps, moves, modulo_ns, [width, height](Cell cell, int dx, int dy) {
+      return ModuloMove(cell, dx, dy, width, height);
+    });
+    consistent = consistent && by_board == by_modulo;
+    std::cout << test.name << ": Board::Move " << board_ns << " ns, modulo " << modulo_ns << " ns";
+
+    if (width == 32 && height == 32) {
+      double inline_ns = 0.0;
+      Cell const by_template = Walk(steps, moves, inline_ns, [](Cell cell, int dx, int dy) {
+        return FixedGeometry<32, 32>::Move(cell, dx, dy);
+      });
+      consistent = consistent && by_template == by_board;
+      std::cout << ", FixedGeometry inlined " << inline_ns << " ns";
+    }
+    std::cout << " per move (end cell " << by_board.x << "," << by_board.y << ")" << std::endl;
+  }
+
+  if (!consistent) {
+    std::cerr << "The move variants ended on different cells." << std::endl;
+    return 1;
+  }
+  return 0;
+}
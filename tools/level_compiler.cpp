@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "level_pack.h"
+
+/*
+ * Compiles ASCII-art maps into a level pack (see src/level_pack.h).
+ *
+ * Usage: SnakeLevelCompiler <output.slp> <map.txt>...
+ *
+ * A map file holds one or more levels. Lines starting with ';' are comments.
+ *
+ *   level <name>      starts a new level; the rows below are its map
+ *   repeat <ms>       restarts the waves after this period (default: play once)
+ *   wave <ms>         the rows below are obstacles appearing <ms> after start
+ *
+ * Map rows use '#' for a wall, 'S' for a spawn point (the first one is the
+ * snake's start) and '.' for an empty cell. Wave rows use '#' for an obstacle
+ * and '.' otherwise, and must have the same size as the level map.
+ */
+
+namespace {
+
+struct MapBlock {
+  std::uint32_t at_ms{0};
+  std::vector<std::string> rows;
+};
+
+struct LevelText {
+  std::string name;
+  std::uint32_t repeat_ms{0};
+  MapBlock map;
+  std::vector<MapBlock> waves;
+};
+
+std::string Where(const std::string &file, int line) { return file + ":" + std::to_string(line) + ": "; }
+
+void ParseFile(const std::string &file, std::vector<LevelText> &levels) {
+  std::ifstream input(file);
+  if (!input) {
+    throw std::runtime_error("Unable to open " + file);
+  }
+
+  std::string line;
+  int line_number = 0;
+  MapBlock *block = nullptr;
+  while (std::getline(input, line)) {
+    line_number++;
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (line.empty() || line[0] == ';') continue;
+
+    if (line.compare(0, 6, "level ") == 0) {
+      levels.push_back(LevelText{});
+      levels.back().name = line.substr(6);
+      block = &levels.back().map;
+    } else if (levels.empty()) {
+      throw std::runtime_error(Where(file, line_number) + "expected 'level <name>'");
+    } else if (line.compare(0, 7, "repeat ") == 0) {
+      levels.back().repeat_ms = static_cast<std::uint32_t>(std::stoul(line.substr(7)));
+    } else if (line.compare(0, 5, "wave ") == 0) {
+      levels.back().waves.push_back(MapBlock{static_cast<std::uint32_t>(std::stoul(line.substr(5))), {}});
+      block = &levels.back().waves.back();
+    } else {
+      if (line.find_first_not_of(block == &levels.back().map ? "#S." : "#.") != std::string::npos) {
+        throw std::runtime_error(Where(file, line_number) + "unexpected character in map row");
+      }
+      if (!block->rows.empty() && line.size() != block->rows.front().size()) {
+        throw std::runtime_error(Where(file, line_number) + "rows must all have the same width");
+      }
+      block->rows.push_back(line);
+    }
+  }
+}
+
+LevelSource_t Compile(const LevelText &text) {
+  LevelSource_t level;
+  level.name = text.name;
+  level.repeat_ms = text.repeat_ms;
+  level.height = static_cast<int>(text.map.rows.size());
+  level.width = level.height > 0 ? static_cast<int>(text.map.rows.front().size()) : 0;
+
+  for (int y = 0; y < level.height; ++y) {
+    for (int x = 0; x < level.width; ++x) {
+      char c = text.map.rows[y][x];
+      if (c == '#') level.walls.emplace_back(x, y);
+      if (c == 'S') level.spawns.emplace_back(x, y);
+    }
+  }
+
+  std::uint32_t previous_ms = 0;
+  for (auto const &wave : text.waves) {
+    if (static_cast<int>(wave.rows.size()) != level.height ||
+        (!wave.rows.empty() && static_cast<int>(wave.rows.front().size()) != level.width)) {
+      throw std::runtime_error("Level " + text.name + ": every wave must match the map size");
+    }
+    if (wave.at_ms < previous_ms) {
+      throw std::runtime_error("Level " + text.name + ": waves must be listed in time order");
+    }
+    previous_ms = wave.at_ms;
+
+    std::vector<Cell> cells;
+    for (int y = 0; y < level.height; ++y) {
+      for (int x = 0; x < level.width; ++x) {
+        if (wave.rows[y][x] == '#') cells.emplace_back(x, y);
+      }
+    }
+    level.waves.emplace_back(wave.at_ms, std::move(cells));
+  }
+  return level;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <output.slp> <map.txt>..." << std::endl;
+    return 1;
+  }
+
+  try {
+    std::vector<LevelText> texts;
+    for (int i = 2; i < argc; ++i) {
+      ParseFile(argv[i], texts);
+    }
+
+    std::vector<LevelSource_t> levels;
+    for (auto const &text : texts) {
+      levels.push_back(Compile(text));
+      std::cout << levels.size() - 1 << ": " << text.name << " (" << levels.back().width << "x"
+                << levels.back().height << ", " << levels.back().walls.size() << " walls, "
+                << levels.back().waves.size() << " waves)" << std::endl;
+    }
+    LevelPack::Write(argv[1], levels);
+  } catch (const std::exception &error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "net_protocol.h"
+
+/*
+ * Load generator for the tick server (SnakeGame --server <port>).
+ *
+ * Usage: SnakeLoadGen [clients] [seconds] [port] [level]
+ *
+ * Every simulated client sends one input per tick with an occasional random
+ * turn, rebuilds its game from the snapshots and checks each snapshot against
+ * the game it rebuilt so far: the tail never moves back, and the first cell
+ * appended after a snapshot is that snapshot's head. At the end the tool
+ * reports the received snapshots and bytes per client.
+ */
+
+namespace {
+
+struct Client {
+  int socket_fd;
+  Net::SnapshotState state;
+  std::uint64_t bytes{0};
+  std::uint64_t snapshots{0};
+  std::uint64_t errors{0};
+};
+
+bool OpenClient(Client &client) {
+  client.socket_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  return client.socket_fd >= 0;
+}
+
+// What a client had rebuilt before applying a snapshot.
+struct Rebuilt {
+  Cell head;
+  std::uint64_t next_index;
+  std::uint64_t tail_index;
+  bool synced;
+};
+
+/**
+ * Checks a newly applied snapshot against the game rebuilt before it. Each
+ * step appends the previous head to the body, so when both states held every
+ * cell, cells were appended exactly when the head moved, and the first of them
+ * is the previous head.
+ */
+bool Consistent(Net::SnapshotState const &state, Rebuilt const &previous) {
+  if (state.tail_index < previous.tail_index || state.body.size() != state.next_index - state.tail_index) {
+    return false;
+  }
+  if (!previous.synced || !state.synced) return true;
+  bool const appended = state.next_index != previous.next_index;
+  if (appended != (state.head != previous.head)) return false;
+  if (appended && previous.next_index >= state.tail_index) {
+    return state.body[previous.next_index - state.tail_index] == previous.head;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::size_t client_count = (argc > 1) ? std::stoul(argv[1]) : 100;
+  int seconds = (argc > 2) ? std::stoi(argv[2]) : 10;
+  std::uint16_t port = (argc > 3) ? static_cast<std::uint16_t>(std::stoul(argv[3])) : Net::kDefaultPort;
+  std::uint8_t level = (argc > 4) ? static_cast<std::uint8_t>(std::stoul(argv[4])) : 1;
+  if (client_count < 1 || seconds < 1) {
+    std::cerr << "Usage: " << argv[0] << " [clients] [seconds] [port] [level]" << std::endl;
+    return 1;
+  }
+
+  sockaddr_in server{};
+  server.sin_family = AF_INET;
+  server.sin_port = htons(port);
+  server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  std::vector<Client> clients(client_count);
+  for (auto &client : clients) {
+    if (!OpenClient(client)) {
+      std::cerr << "Unable to create client socket" << std::endl;
+      return 1;
+    }
+  }
+
+  std::mt19937 engine(12345);
+  std::uniform_int_distribution<int> turn(0, 29);
+  std::vector<std::uint8_t> buffer(Net::kMaxDatagram);
+  auto const period = std::chrono::microseconds(1000000 / 60);
+  auto const end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+  auto next_tick = std::chrono::steady_clock::now();
+
+  while (std::chrono::steady_clock::now() < end) {
+    for (auto &client : clients) {
+      ssize_t size;
+      while ((size = recv(client.socket_fd, buffer.data(), buffer.size(), 0)) > 0) {
+        client.bytes += static_cast<std::uint64_t>(size);
+        Rebuilt const previous{client.state.head, client.state.next_index, client.state.tail_index,
+                               client.state.synced};
+        if (client.state.Apply(buffer.data(), static_cast<std::size_t>(size))) {
+          client.snapshots++;
+          if (!Consistent(client.state, previous)) {
+            client.errors++;
+          }
+        }
+      }
+
+      // Turn now and then, otherwise just acknowledge.
+      int roll = turn(engine);
+      std::uint8_t direction = (roll < 4) ? static_cast<std::uint8_t>(roll) : 0xFF;
+      Net::InputMessage message = client.state.MakeInput(direction, level);
+      sendto(client.socket_fd, &message, sizeof(message), 0,
+             reinterpret_cast<const sockaddr *>(&server), sizeof(server));
+    }
+
+    next_tick += period;
+    std::this_thread::sleep_until(next_tick);
+  }
+
+  std::uint64_t total_bytes = 0;
+  std::uint64_t total_snapshots = 0;
+  std::uint64_t total_errors = 0;
+  std::size_t longest = 0;
+  for (auto &client : clients) {
+    Net::InputMessage bye = client.state.MakeInput(0xFF, level);
+    bye.type = Net::kBye;
+    sendto(client.socket_fd, &bye, sizeof(bye), 0, reinterpret_cast<const sockaddr *>(&server), sizeof(server));
+    close(client.socket_fd);
+
+    total_bytes += client.bytes;
+    total_snapshots += client.snapshots;
+    total_errors += client.errors;
+    if (client.state.body.size() > longest) longest = client.state.body.size();
+  }
+
+  std::cout << "Clients: " << client_count << std::endl;
+  std::cout << "Snapshots per client: " << total_snapshots / client_count << std::endl;
+  std::cout << "Bytes per client per second: " << total_bytes / client_count / seconds << std::endl;
+  std::cout << "Bytes per snapshot: " << (total_snapshots ? total_bytes / total_snapshots : 0) << std::endl;
+  std::cout << "Longest body: " << longest << std::endl;
+  std::cout << "Errors: " << total_errors << std::endl;
+  return total_errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "metrics.h"
+
+/*
+ * Prints the live metrics of running games (SnakeGame --metrics) in the
+ * Prometheus text exposition format.
+ *
+ * Usage: SnakeMetrics [pid]...
+ *
+ * Without arguments every segment found in /dev/shm is read. Values are read
+ * straight from shared memory, so scraping never blocks the game. Each sample
+ * is labelled with the pid of its game. Segments left behind by games that
+ * are no longer running are skipped; the next game started removes them.
+ */
+
+namespace {
+
+const Metrics::Segment *MapSegment(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) return nullptr;
+  // Reading past the end of a shorter segment would raise SIGBUS.
+  struct stat status;
+  if (fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(Metrics::Segment)) {
+    close(fd);
+    return nullptr;
+  }
+  void *mapping = mmap(nullptr, sizeof(Metrics::Segment), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) return nullptr;
+
+  const Metrics::Segment *segment = static_cast<const Metrics::Segment *>(mapping);
+  if (segment->magic.load(std::memory_order_acquire) != Metrics::kMagic || segment->version != Metrics::kVersion ||
+      segment->count != Metrics::kCount || (kill(segment->pid, 0) != 0 && errno == ESRCH)) {
+    munmap(mapping, sizeof(Metrics::Segment));
+    return nullptr;
+  }
+  return segment;
+}
+
+std::vector<std::string> FindSegments(void) {
+  std::vector<std::string> names;
+  std::string const prefix = Metrics::kNamePrefix + 1;  // Without the leading '/'
+  DIR *directory = opendir("/dev/shm");
+  if (directory == nullptr) return names;
+  while (dirent *entry = readdir(directory)) {
+    if (std::strncmp(entry->d_name, prefix.c_str(), prefix.size()) == 0) {
+      names.push_back(std::string("/") + entry->d_name);
+    }
+  }
+  closedir(directory);
+  return names;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  std::vector<std::string> names;
+  for (int i = 1; i < argc; ++i) {
+    names.push_back(Metrics::kNamePrefix + std::string(argv[i]));
+  }
+  if (argc == 1) {
+    names = FindSegments();
+  }
+
+  std::vector<const Metrics::Segment *> segments;
+  for (auto const &name : names) {
+    if (const Metrics::Segment *segment = MapSegment(name)) {
+      segments.push_back(segment);
+    } else if (argc > 1) {
+      std::cerr << "No metrics for " << name << std::endl;
+    }
+  }
+
+  for (std::uint32_t id = 0; id < Metrics::kCount && !segments.empty(); ++id) {
+    Metrics::Slot const &description = segments.front()->slots[id];
+    bool const counter = description.kind == Metrics::kCounter;
+    std::cout << "# HELP " << description.name << " " << description.help << "\n"
+              << "# TYPE " << description.name << (counter ? " counter" : " gauge") << "\n";
+    for (const Metrics::Segment *segment : segments) {
+      std::uint64_t bits = segment->slots[id].value.load(std::memory_order_relaxed);
+      std::cout << description.name << "{pid=\"" << segment->pid << "\"} ";
+      if (counter) {
+        std::cout << bits << "\n";
+      } else {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        std::cout << value << "\n";
+      }
+    }
+  }
+
+  for (const Metrics::Segment *segment : segments) {
+    munmap(const_cast<Metrics::Segment *>(segment), sizeof(Metrics::Segment));
+  }
+  return segments.empty() && argc > 1 ? 1 : 0;
+}